@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Pothos/Callable.hpp>
+#include <Pothos/Init.hpp>
+#include <Pothos/Plugin.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+//
+// Prints the throughput of every NumPy block matching the given path prefix
+// as JSON, for comparing builds.
+//
+// Usage: PothosNumPyBenchmark [path prefix] [elements per measurement] [parallel chains]
+//
+
+int main(int argc, char* argv[])
+{
+    const std::string pathPrefix = (argc > 1) ? argv[1] : "/numpy";
+    const size_t numElements = (argc > 2) ? std::stoull(argv[2]) : (1 << 22);
+    const size_t numChains = (argc > 3) ? std::stoull(argv[3]) : 1;
+
+    try
+    {
+        Pothos::ScopedInit init;
+
+        auto benchmark = Pothos::PluginRegistry::get("/numpy/benchmark/run").getObject().extract<Pothos::Callable>();
+        std::cout << benchmark.call<std::string>(pathPrefix, numElements, numChains) << std::endl;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,19 @@
+#include "Cpp/ElementwiseFunctions.hpp"
+#include "Cpp/NativeFactory.hpp"
+#include "Cpp/NToOneBlock.hpp"
+#include "Cpp/OneToOneBlock.hpp"
+#include "Cpp/TwoToOneBlock.hpp"
+
 #include <Pothos/Callable.hpp>
 #include <Pothos/Framework.hpp>
 #include <Pothos/Plugin.hpp>
 #include <Pothos/Proxy.hpp>
 
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 static Pothos::Object FactoryFunc(
     const Pothos::Object *args,
     const size_t numArgs,
@@ -26,6 +37,28 @@ static Pothos::Object FactoryFunc(
     return Pothos::Object(block);
 }
 
+// For blocks with a native implementation. If the given parameters don't
+// correspond to a native block, fall back to the Python implementation.
+template <template <typename> class BlockClass, template <typename> class Func, typename... Types>
+static Pothos::Object NativeFactoryFunc(
+    const Pothos::Object *args,
+    const size_t numArgs,
+    const std::string& blockPath,
+    const std::string& pythonName)
+{
+    if(numArgs > 0)
+    {
+        auto* block = PothosNumPy::makeNativeBlock<BlockClass, Func, Types...>(
+                          blockPath,
+                          PothosNumPy::objectToDType(args[0]),
+                          args,
+                          numArgs);
+        if(block) return Pothos::Object(block);
+    }
+
+    return FactoryFunc(args, numArgs, pythonName);
+}
+
 static const std::vector<Pothos::BlockRegistry> blockRegistries =
 {
 %for factory in factories:
@@ -105,7 +105,12 @@ def processYAMLFile(yamlPath):
 
     return fullEntries
 
-def generateCppFactory(func,name):
+def generateCppFactory(func,name,makoVars=None):
+    if makoVars and makoVars["native"]:
+        nativeFactoryArgs = ["PothosNumPy::"+makoVars["class"], "PothosNumPy::"+name] + makoVars["nativeTypes"]
+        return 'Pothos::BlockRegistry("/numpy/{0}", Pothos::Callable(&NativeFactoryFunc<{1}>).bind<std::string>("/numpy/{2}", 2).bind<std::string>("{3}", 3))' \
+               .format(func, ", ".join(nativeFactoryArgs), makoVars["blockRegistryPath"], name)
+
     return 'Pothos::BlockRegistry("/numpy/{0}", Pothos::Callable(&FactoryFunc).bind<std::string>("{1}", 2))' \
            .format(func, name)
 
@@ -127,6 +132,25 @@ def blockTypeToDTypeChooser(blockTypeYAML):
 
     return args
 
+# Blocks of these classes have a C++ implementation in the Cpp directory, which
+# is used when their YAML entry has "native: true".
+NativeBlockClasses = ["OneToOneBlock", "TwoToOneBlock", "NToOneBlock"]
+
+CppTypes = dict(
+    int=["std::int8_t", "std::int16_t", "std::int32_t", "std::int64_t"],
+    uint=["std::uint8_t", "std::uint16_t", "std::uint32_t", "std::uint64_t"],
+    float=["float", "double"],
+    complex=["std::complex<float>", "std::complex<double>"]
+)
+
+def blockTypeToCppTypes(blockTypeYAML):
+    if "all" in blockTypeYAML:
+        yamlToProcess = ["int", "uint", "float", "complex"]
+    else:
+        yamlToProcess = blockTypeYAML
+
+    return [cppType for typeStr in yamlToProcess for cppType in CppTypes[typeStr]]
+
 def blockTypeToDTypeDefault(blockTypeYAML):
     dtypeChooser = blockTypeToDTypeChooser(blockTypeYAML)
 
@@ -252,9 +276,14 @@ def generateMakoVars(func,yaml):
         makoVars["factoryVars"] += ["args"]
         makoVars["args"] = "[{0}]".format(", ".join(yaml["args"]))
 
-    if "kwargs" in yaml:
+    # Capability flags are passed into the block class as kwargs.
+    kwargs = list(yaml.get("kwargs", []))
+    if yaml.get("supportsOut", False):
+        kwargs += ["supportsOut=True"]
+
+    if kwargs:
         makoVars["factoryVars"] += ["kwargs"]
-        makoVars["kwargs"] = "dict({0})".format(", ".join(yaml["kwargs"]))
+        makoVars["kwargs"] = "dict({0})".format(", ".join(kwargs))
 
     if "funcArgs" in yaml:
         assert(type(yaml["funcArgs"]) is list)
@@ -292,6 +321,11 @@ def generateMakoVars(func,yaml):
         else:
             raise RuntimeError("Invalid block pattern.")
 
+    # Native blocks are instantiated based on their input type.
+    makoVars["native"] = yaml.get("native", False) and (makoVars["class"] in NativeBlockClasses) and not makoVars["subclass"]
+    if makoVars["native"]:
+        makoVars["nativeTypes"] = blockTypeToCppTypes(yaml.get("blockType", yaml.get("inputType")))
+
     if "nanFunc" in makoVars:
         funcAsParam = "({0}.{1} if ignoreNaN else {0}.{2})".format(makoVars["prefix"], makoVars["nanFunc"], func)
         makoVars["factoryParams"] += ["ignoreNaN"]
@@ -463,11 +497,11 @@ def generateCppOutput(allMakoVars):
     factories = []
     docs = []
     for makoVars in allMakoVars:
-        factories += [generateCppFactory(makoVars["blockRegistryPath"], makoVars["name"])]
+        factories += [generateCppFactory(makoVars["blockRegistryPath"], makoVars["name"], makoVars)]
         docs += [makoVarsToBlockDesc(makoVars)]
         if "alias" in makoVars:
             for alias in makoVars["alias"]:
-                factories += [generateCppFactory(alias, makoVars["name"])]
+                factories += [generateCppFactory(alias, makoVars["name"], makoVars)]
 
     # Add C++-only blocks.
     factoryOnlyYAMLPath = os.path.join(BlocksDir, "FactoryOnly.yaml")
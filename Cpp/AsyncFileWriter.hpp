@@ -0,0 +1,404 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace PothosNumPy
+{
+
+//
+// Writes a file on a background thread, so a block's work() only copies
+// samples into a buffer, and disk latency spikes don't stall the topology
+// until every buffer is full. Writes are done in order, at the offsets they
+// were queued at.
+//
+// Syncing only flushes this file, unlike os.sync(), which flushes every
+// filesystem on the machine.
+//
+// Each buffer is written with a single large write. If writing starts at an
+// unaligned offset, such as the end of a file being appended to, the first
+// buffer is cut short so every later write starts on a page boundary.
+//
+
+enum class FileSyncMode
+{
+    // Leave flushing to the OS.
+    Never,
+
+    // Sync once the file is closed.
+    OnClose,
+
+    // Sync every time the given number of bytes has been written, and once
+    // the file is closed.
+    Interval
+};
+
+namespace detail
+{
+#ifdef _WIN32
+    static inline int openFile(const std::string& filepath, const bool truncate)
+    {
+        return _open(filepath.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+    }
+
+    static inline bool writeFileAt(const int fd, std::uint64_t offset, const char* data, size_t size)
+    {
+        if(_lseeki64(fd, std::int64_t(offset), SEEK_SET) < 0) return false;
+
+        while(size > 0)
+        {
+            const int numWritten = _write(fd, data, unsigned(std::min<size_t>(size, 1 << 30)));
+            if(numWritten <= 0) return false;
+
+            data += numWritten;
+            size -= numWritten;
+        }
+
+        return true;
+    }
+
+    static inline bool syncFile(const int fd)
+    {
+        return (0 == _commit(fd));
+    }
+
+    static inline bool closeFile(const int fd)
+    {
+        return (0 == _close(fd));
+    }
+#else
+    static inline int openFile(const std::string& filepath, const bool truncate)
+    {
+        return ::open(filepath.c_str(), O_WRONLY | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+    }
+
+    static inline bool writeFileAt(const int fd, std::uint64_t offset, const char* data, size_t size)
+    {
+        while(size > 0)
+        {
+            const auto numWritten = ::pwrite(fd, data, size, off_t(offset));
+            if(numWritten < 0)
+            {
+                if(EINTR == errno) continue;
+                return false;
+            }
+
+            data += numWritten;
+            size -= numWritten;
+            offset += numWritten;
+        }
+
+        return true;
+    }
+
+    static inline bool syncFile(const int fd)
+    {
+        return (0 == ::fsync(fd));
+    }
+
+    static inline bool closeFile(const int fd)
+    {
+        return (0 == ::close(fd));
+    }
+#endif
+}
+
+class AsyncFileWriter
+{
+    public:
+        // One buffer is filled while the other is written.
+        static constexpr size_t DefaultBufferSize = 1 << 23;
+        static constexpr size_t DefaultNumBuffers = 2;
+        static constexpr size_t WriteAlignment = 1 << 12;
+
+        AsyncFileWriter(
+            const std::string& filepath,
+            const bool truncate,
+            const FileSyncMode syncMode,
+            const std::uint64_t syncInterval,
+            const size_t bufferSize = DefaultBufferSize,
+            const size_t numBuffers = DefaultNumBuffers
+        ):
+            _filepath(filepath),
+            _fd(detail::openFile(filepath, truncate)),
+            _syncMode(syncMode),
+            _syncInterval(syncInterval),
+            _bufferSize(bufferSize),
+            _bufferLimit(bufferSize),
+            _bufferOffset(0),
+            _blockedSeconds(0.0),
+            _numWriting(0),
+            _stopping(false),
+            _failed(false)
+        {
+            if(_fd < 0)
+            {
+                throw Pothos::OpenFileException("Failed to open file for writing", filepath);
+            }
+            if((FileSyncMode::Interval == syncMode) && (0 == syncInterval))
+            {
+                detail::closeFile(_fd);
+                throw Pothos::InvalidArgumentException("Sync interval must be positive.");
+            }
+
+            for(size_t buffer = 0; buffer < std::max<size_t>(numBuffers, 2); ++buffer)
+            {
+                _freeBuffers.emplace_back();
+                _freeBuffers.back().reserve(bufferSize);
+            }
+            _buffer = this->takeFreeBuffer();
+
+            _thread = std::thread(&AsyncFileWriter::writerLoop, this);
+        }
+
+        // Without close(), the partially filled buffer is discarded, and the
+        // file isn't synced.
+        virtual ~AsyncFileWriter()
+        {
+            if(_thread.joinable()) this->stopThread();
+            if(_fd >= 0) detail::closeFile(_fd);
+        }
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        // Subsequent writes start at the given offset.
+        void seek(const std::uint64_t offset)
+        {
+            this->submitBuffer();
+            _bufferOffset = offset;
+            this->updateBufferLimit();
+        }
+
+        // Copies the data into the current buffer. This only blocks if every
+        // buffer is waiting to be written.
+        void write(const void* data, const size_t size)
+        {
+            const auto* bytes = reinterpret_cast<const char*>(data);
+            for(size_t pos = 0; pos < size;)
+            {
+                const size_t copySize = std::min(size - pos, _bufferLimit - _buffer.size());
+                _buffer.insert(_buffer.end(), bytes + pos, bytes + pos + copySize);
+                pos += copySize;
+
+                if(_bufferLimit == _buffer.size()) this->submitBuffer();
+            }
+        }
+
+        // Overwrite data that was already written, such as a header, without
+        // changing where subsequent writes go.
+        void writeAt(const std::uint64_t offset, const void* data, const size_t size)
+        {
+            this->submitBuffer();
+
+            const auto* bytes = reinterpret_cast<const char*>(data);
+            this->enqueue(offset, std::vector<char>(bytes, bytes + size), false);
+        }
+
+        // Write everything queued, sync according to the sync mode, and close
+        // the file.
+        void close()
+        {
+            if(_fd < 0) return;
+
+            this->submitBuffer();
+            this->stopThread();
+
+            bool failed = _failed;
+            if(!failed && (FileSyncMode::Never != _syncMode)) failed = !detail::syncFile(_fd);
+            if(!detail::closeFile(_fd)) failed = true;
+            _fd = -1;
+
+            if(failed)
+            {
+                throw Pothos::WriteFileException("Failed to write file", _filepath);
+            }
+        }
+
+        // The number of buffers waiting to be written, including the one
+        // being written
+        size_t queueDepth() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _queue.size() + _numWriting;
+        }
+
+        // Time write() spent waiting for a buffer to be written
+        double blockedSeconds() const
+        {
+            return _blockedSeconds;
+        }
+
+    private:
+        struct WriteOp
+        {
+            std::uint64_t offset;
+            std::vector<char> data;
+
+            // Whether data is returned to the free buffers once written
+            bool pooled;
+        };
+
+        std::string _filepath;
+        int _fd;
+        FileSyncMode _syncMode;
+        std::uint64_t _syncInterval;
+
+        // Only used by the caller's thread
+        size_t _bufferSize;
+        size_t _bufferLimit;
+        std::vector<char> _buffer;
+        std::uint64_t _bufferOffset;
+        double _blockedSeconds;
+
+        std::thread _thread;
+        mutable std::mutex _mutex;
+        std::condition_variable _queueCond;
+        std::condition_variable _freeCond;
+        std::deque<WriteOp> _queue;
+        std::vector<std::vector<char>> _freeBuffers;
+        size_t _numWriting;
+        bool _stopping;
+        bool _failed;
+
+        std::vector<char> takeFreeBuffer()
+        {
+            auto buffer = std::move(_freeBuffers.back());
+            _freeBuffers.pop_back();
+
+            return buffer;
+        }
+
+        void enqueue(const std::uint64_t offset, std::vector<char>&& data, const bool pooled)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(_failed)
+                {
+                    throw Pothos::WriteFileException("Failed to write file", _filepath);
+                }
+
+                _queue.emplace_back();
+                _queue.back().offset = offset;
+                _queue.back().data = std::move(data);
+                _queue.back().pooled = pooled;
+            }
+            _queueCond.notify_one();
+        }
+
+        void submitBuffer()
+        {
+            if(_buffer.empty()) return;
+
+            const auto offset = _bufferOffset;
+            _bufferOffset += _buffer.size();
+            this->updateBufferLimit();
+            this->enqueue(offset, std::move(_buffer), true);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if(_freeBuffers.empty())
+            {
+                const auto startTime = std::chrono::steady_clock::now();
+                _freeCond.wait(lock, [this](){return !_freeBuffers.empty();});
+
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+                _blockedSeconds += elapsed.count();
+            }
+
+            _buffer = this->takeFreeBuffer();
+        }
+
+        // Fill the current buffer up to the next aligned offset.
+        void updateBufferLimit()
+        {
+            const auto misalignment = size_t(_bufferOffset % WriteAlignment);
+            _bufferLimit = (_bufferSize > misalignment) ? (_bufferSize - misalignment) : _bufferSize;
+        }
+
+        void stopThread()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _queueCond.notify_one();
+
+            _thread.join();
+        }
+
+        void writerLoop()
+        {
+            std::uint64_t bytesSinceSync = 0;
+
+            while(true)
+            {
+                WriteOp op;
+                bool failed = false;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _queueCond.wait(lock, [this](){return _stopping || !_queue.empty();});
+                    if(_queue.empty()) return;
+
+                    op = std::move(_queue.front());
+                    _queue.pop_front();
+                    _numWriting = 1;
+                    failed = _failed;
+                }
+
+                // After a failure, buffers are still returned so write()
+                // doesn't block forever, but nothing else is written.
+                if(!failed)
+                {
+                    failed = !detail::writeFileAt(_fd, op.offset, op.data.data(), op.data.size());
+
+                    bytesSinceSync += op.data.size();
+                    if(!failed && (FileSyncMode::Interval == _syncMode) && (bytesSinceSync >= _syncInterval))
+                    {
+                        failed = !detail::syncFile(_fd);
+                        bytesSinceSync = 0;
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _numWriting = 0;
+                    if(failed) _failed = true;
+
+                    if(op.pooled)
+                    {
+                        op.data.clear();
+                        _freeBuffers.emplace_back(std::move(op.data));
+                    }
+                }
+                _freeCond.notify_one();
+            }
+        }
+};
+
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <Pothos/Framework.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace PothosNumPy
+{
+
+//
+// Native equivalent of BaseBlock.py's work loop instrumentation. The native
+// blocks expose the same probes as the Python blocks so a stalled topology
+// can be inspected the same way regardless of which blocks are native.
+//
+
+class BaseBlock: public Pothos::Block
+{
+    public:
+        BaseBlock(const std::string& blockPath): Pothos::Block()
+        {
+            // Match the Python blocks' naming.
+            this->setName(blockPath);
+
+            this->resetWorkStats();
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, workCalls));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, elementsConsumed));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, elementsProduced));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, funcSeconds));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, copySeconds));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, zeroElementReturns));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, workStats));
+            this->registerCall(this, POTHOS_FCN_TUPLE(BaseBlock, resetWorkStats));
+
+            this->registerProbe("workCalls");
+            this->registerProbe("elementsConsumed");
+            this->registerProbe("elementsProduced");
+            this->registerProbe("funcSeconds");
+            this->registerProbe("copySeconds");
+            this->registerProbe("zeroElementReturns");
+            this->registerProbe("workStats");
+        }
+
+        virtual ~BaseBlock() = default;
+
+        size_t workCalls() const
+        {
+            return _workCalls;
+        }
+
+        size_t elementsConsumed() const
+        {
+            return _elementsConsumed;
+        }
+
+        size_t elementsProduced() const
+        {
+            return _elementsProduced;
+        }
+
+        double funcSeconds() const
+        {
+            return _funcSeconds;
+        }
+
+        double copySeconds() const
+        {
+            return _copySeconds;
+        }
+
+        size_t zeroElementReturns() const
+        {
+            return _zeroElementReturns;
+        }
+
+        std::string workStats() const
+        {
+            nlohmann::json stats;
+            stats["workCalls"] = _workCalls;
+            stats["elementsConsumed"] = _elementsConsumed;
+            stats["elementsProduced"] = _elementsProduced;
+            stats["funcSeconds"] = _funcSeconds;
+            stats["copySeconds"] = _copySeconds;
+            stats["zeroElementReturns"] = _zeroElementReturns;
+
+            return stats.dump();
+        }
+
+        void resetWorkStats()
+        {
+            _workCalls = 0;
+            _elementsConsumed = 0;
+            _elementsProduced = 0;
+            _funcSeconds = 0.0;
+            _copySeconds = 0.0;
+            _zeroElementReturns = 0;
+        }
+
+    protected:
+        // Called at the start of each work() call. Returns whether there is
+        // anything to do, so the caller can return early.
+        bool countWork(const size_t elems)
+        {
+            ++_workCalls;
+            if(0 == elems) ++_zeroElementReturns;
+
+            return (elems > 0);
+        }
+
+        // For blocks with multiple inputs, consumed is the number of elements
+        // consumed from each input.
+        void countElements(const size_t consumed, const size_t produced)
+        {
+            _elementsConsumed += consumed;
+            _elementsProduced += produced;
+        }
+
+        // Time spent in the kernel itself
+        template <typename Fcn>
+        void timeFunc(const Fcn& fcn)
+        {
+            _funcSeconds += timeCall(fcn);
+        }
+
+        // Time spent copying between buffers
+        template <typename Fcn>
+        void timeCopy(const Fcn& fcn)
+        {
+            _copySeconds += timeCall(fcn);
+        }
+
+    private:
+        size_t _workCalls;
+        size_t _elementsConsumed;
+        size_t _elementsProduced;
+        double _funcSeconds;
+        double _copySeconds;
+        size_t _zeroElementReturns;
+
+        template <typename Fcn>
+        static double timeCall(const Fcn& fcn)
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            fcn();
+
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+};
+
+}
@@ -0,0 +1,398 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <nlohmann/json.hpp>
+
+#include <Pothos/Callable.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// Measures the sustained throughput of every registered NumPy block for each
+// of its supported types and a range of input buffer sizes. Blocks are found
+// through their documentation entries, which list their factory parameters
+// and supported types. Only blocks whose parameters are all type or channel
+// count parameters are measured, since other parameters have no generic
+// sensible value. Given more than one chain, each block is also measured
+// in that many independent chains running at once, to show whether its
+// throughput scales across threads.
+//
+
+static const std::string DocsPrefix = "/blocks/docs";
+
+static const std::vector<size_t> BufferSizes = {1 << 10, 1 << 13, 1 << 16};
+
+static constexpr size_t BenchmarkNChans = 2;
+
+// Time spent waiting to confirm the topology is idle, not spent in the block
+static constexpr double IdleDurationSecs = 0.01;
+
+static constexpr double TimeoutSecs = 60.0;
+
+//
+// Inputs
+//
+
+// Keep integer inputs nonzero so division-based blocks don't take
+// any special-case paths.
+template <typename T>
+static void fillInputs(T* buff, size_t numElements)
+{
+    for(size_t elem = 0; elem < numElements; ++elem)
+    {
+        buff[elem] = T((elem % 100) + 1);
+    }
+}
+
+template <>
+void fillInputs<float>(float* buff, size_t numElements)
+{
+    for(size_t elem = 0; elem < numElements; ++elem)
+    {
+        buff[elem] = 0.1f + (0.8f * float(elem % 1000) / 1000.0f);
+    }
+}
+
+template <>
+void fillInputs<double>(double* buff, size_t numElements)
+{
+    for(size_t elem = 0; elem < numElements; ++elem)
+    {
+        buff[elem] = 0.1 + (0.8 * double(elem % 1000) / 1000.0);
+    }
+}
+
+template <>
+void fillInputs<std::complex<float>>(std::complex<float>* buff, size_t numElements)
+{
+    fillInputs(reinterpret_cast<float*>(buff), numElements*2);
+}
+
+template <>
+void fillInputs<std::complex<double>>(std::complex<double>* buff, size_t numElements)
+{
+    fillInputs(reinterpret_cast<double*>(buff), numElements*2);
+}
+
+static Pothos::BufferChunk getInputs(const Pothos::DType& dtype, size_t numElements)
+{
+    Pothos::BufferChunk inputs(dtype, numElements);
+
+    #define IfTypeThenFill(typeStr, ctype) \
+        if(dtype.name() == typeStr) \
+        { \
+            fillInputs<ctype>(inputs.as<ctype*>(), numElements); \
+            return inputs; \
+        }
+
+    IfTypeThenFill("int8", std::int8_t)
+    IfTypeThenFill("int16", std::int16_t)
+    IfTypeThenFill("int32", std::int32_t)
+    IfTypeThenFill("int64", std::int64_t)
+    IfTypeThenFill("uint8", std::uint8_t)
+    IfTypeThenFill("uint16", std::uint16_t)
+    IfTypeThenFill("uint32", std::uint32_t)
+    IfTypeThenFill("uint64", std::uint64_t)
+    IfTypeThenFill("float32", float)
+    IfTypeThenFill("float64", double)
+    IfTypeThenFill("complex_float32", std::complex<float>)
+    IfTypeThenFill("complex_float64", std::complex<double>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+//
+// Block discovery
+//
+
+struct BenchmarkableBlock
+{
+    std::string path;
+    std::vector<std::string> types;
+    bool hasNChans;
+};
+
+// Matches the DTypeChooser arguments in GenBlocks.py
+static const std::unordered_map<std::string, std::vector<std::string>> DTypeChooserTypes =
+{
+    {"int",    {"int8", "int16", "int32", "int64"}},
+    {"uint",   {"uint8", "uint16", "uint32", "uint64"}},
+    {"float",  {"float32", "float64"}},
+    {"cfloat", {"complex_float32", "complex_float64"}},
+};
+
+static void findDocPaths(const std::string& path, std::vector<std::string>& docPaths)
+{
+    if(Pothos::PluginRegistry::exists(path))
+    {
+        const auto& obj = Pothos::PluginRegistry::get(path).getObject();
+        if(obj.type() == typeid(std::string)) docPaths.emplace_back(path);
+    }
+
+    for(const auto& child: Pothos::PluginRegistry::list(path))
+    {
+        findDocPaths(path + "/" + child, docPaths);
+    }
+}
+
+static std::vector<BenchmarkableBlock> findBenchmarkableBlocks(const std::string& pathPrefix)
+{
+    std::vector<std::string> docPaths;
+    findDocPaths(DocsPrefix + "/numpy", docPaths);
+
+    std::vector<BenchmarkableBlock> blocks;
+    for(const auto& docPath: docPaths)
+    {
+        const auto desc = nlohmann::json::parse(
+                              Pothos::PluginRegistry::get(docPath).getObject().extract<std::string>());
+
+        BenchmarkableBlock block;
+        block.path = desc.value("path", "");
+        block.hasNChans = false;
+        if((block.path != pathPrefix) && (0 != block.path.find(pathPrefix + "/"))) continue;
+
+        bool supported = true;
+        for(const auto& arg: desc.value("args", nlohmann::json::array()))
+        {
+            if(arg == "nchans") block.hasNChans = true;
+            else if(arg != "dtype") supported = false;
+        }
+        if(!supported) continue;
+
+        for(const auto& param: desc.value("params", nlohmann::json::array()))
+        {
+            if(param.value("key", "") != "dtype") continue;
+
+            for(const auto& chooserPair: param.value("widgetKwargs", nlohmann::json::object()).items())
+            {
+                const auto typesIter = DTypeChooserTypes.find(chooserPair.key());
+                if(typesIter == DTypeChooserTypes.end()) continue;
+
+                block.types.insert(
+                    block.types.end(),
+                    typesIter->second.begin(),
+                    typesIter->second.end());
+            }
+        }
+
+        if(!block.types.empty()) blocks.emplace_back(std::move(block));
+    }
+
+    return blocks;
+}
+
+//
+// Measurement
+//
+
+static std::vector<Pothos::PortInfo> getStreamPortInfo(
+    const Pothos::Proxy& block,
+    const std::string& portInfoCall)
+{
+    std::vector<Pothos::PortInfo> streamPortInfo;
+    for(const auto& portInfo: block.call<std::vector<Pothos::PortInfo>>(portInfoCall))
+    {
+        if(!portInfo.isSigSlot) streamPortInfo.emplace_back(portInfo);
+    }
+
+    return streamPortInfo;
+}
+
+// Each chain has its own block, feeders, and collectors, all in one
+// topology, so chains only have the scheduler (and, for Python blocks, the
+// interpreter) in common.
+struct ChainsMeasurement
+{
+    bool native;
+    size_t elementsIn;
+    size_t elementsOut;
+    double seconds;
+};
+
+static ChainsMeasurement measureChains(
+    const BenchmarkableBlock& benchmarkableBlock,
+    const Pothos::DType& dtype,
+    size_t bufferSize,
+    size_t numElements,
+    size_t numChains)
+{
+    ChainsMeasurement measurement;
+    measurement.native = true;
+    measurement.elementsIn = 0;
+    measurement.elementsOut = 0;
+
+    const size_t numBuffers = (numElements + bufferSize - 1) / bufferSize;
+
+    std::vector<Pothos::Proxy> blocks;
+    std::vector<std::vector<Pothos::Proxy>> feeders;
+    std::vector<std::vector<Pothos::Proxy>> collectors;
+    std::vector<std::vector<Pothos::PortInfo>> inputPortInfo;
+    std::vector<std::vector<Pothos::PortInfo>> outputPortInfo;
+
+    for(size_t chain = 0; chain < numChains; ++chain)
+    {
+        auto block = benchmarkableBlock.hasNChans ? Pothos::BlockRegistry::make(benchmarkableBlock.path, dtype, BenchmarkNChans)
+                                                  : Pothos::BlockRegistry::make(benchmarkableBlock.path, dtype);
+        measurement.native &= (block.getEnvironment()->getName() == "managed");
+
+        inputPortInfo.emplace_back(getStreamPortInfo(block, "inputPortInfo"));
+        outputPortInfo.emplace_back(getStreamPortInfo(block, "outputPortInfo"));
+        if(inputPortInfo.back().empty() || outputPortInfo.back().empty())
+        {
+            throw Pothos::InvalidArgumentException("Only blocks with stream inputs and outputs can be measured.");
+        }
+
+        feeders.emplace_back();
+        for(const auto& portInfo: inputPortInfo.back())
+        {
+            const auto inputs = getInputs(portInfo.dtype, bufferSize);
+
+            feeders.back().emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", portInfo.dtype));
+            for(size_t buff = 0; buff < numBuffers; ++buff) feeders.back().back().call("feedBuffer", inputs);
+        }
+
+        collectors.emplace_back();
+        for(const auto& portInfo: outputPortInfo.back())
+        {
+            collectors.back().emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", portInfo.dtype));
+        }
+
+        blocks.emplace_back(std::move(block));
+    }
+
+    {
+        Pothos::Topology topology;
+        for(size_t chain = 0; chain < numChains; ++chain)
+        {
+            for(size_t port = 0; port < inputPortInfo[chain].size(); ++port)
+            {
+                topology.connect(feeders[chain][port], "0", blocks[chain], inputPortInfo[chain][port].name);
+            }
+            for(size_t port = 0; port < outputPortInfo[chain].size(); ++port)
+            {
+                topology.connect(blocks[chain], outputPortInfo[chain][port].name, collectors[chain][port], "0");
+            }
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        topology.commit();
+        if(!topology.waitInactive(IdleDurationSecs, TimeoutSecs))
+        {
+            throw Pothos::RuntimeException("Timed out waiting for block to finish.");
+        }
+        const auto endTime = std::chrono::steady_clock::now();
+
+        measurement.seconds = std::chrono::duration<double>(endTime - startTime).count() - IdleDurationSecs;
+    }
+
+    for(const auto& chainCollectors: collectors)
+    {
+        measurement.elementsIn += numBuffers * bufferSize;
+        measurement.elementsOut += chainCollectors[0].call<Pothos::BufferChunk>("getBuffer").elements();
+    }
+
+    return measurement;
+}
+
+static double getMsps(const ChainsMeasurement& measurement)
+{
+    return (measurement.seconds > 0.0) ? (double(measurement.elementsIn) / measurement.seconds / 1e6) : 0.0;
+}
+
+static nlohmann::json benchmarkBlock(
+    const BenchmarkableBlock& benchmarkableBlock,
+    const Pothos::DType& dtype,
+    size_t bufferSize,
+    size_t numElements,
+    size_t numChains)
+{
+    nlohmann::json result;
+    result["path"] = benchmarkableBlock.path;
+    result["dtype"] = dtype.name();
+    result["bufferSize"] = bufferSize;
+
+    const auto single = measureChains(benchmarkableBlock, dtype, bufferSize, numElements, 1);
+    result["native"] = single.native;
+    result["elementsIn"] = single.elementsIn;
+    result["elementsOut"] = single.elementsOut;
+    result["seconds"] = single.seconds;
+    result["msps"] = getMsps(single);
+
+    // Compare the aggregate throughput of independent chains against
+    // that many times one chain's. A scaling near 1/numChains means the
+    // chains ran one at a time.
+    if(numChains > 1)
+    {
+        const auto parallel = measureChains(benchmarkableBlock, dtype, bufferSize, numElements, numChains);
+
+        nlohmann::json parallelResult;
+        parallelResult["chains"] = numChains;
+        parallelResult["elementsIn"] = parallel.elementsIn;
+        parallelResult["elementsOut"] = parallel.elementsOut;
+        parallelResult["seconds"] = parallel.seconds;
+        parallelResult["msps"] = getMsps(parallel);
+        parallelResult["scaling"] = (getMsps(single) > 0.0) ? (getMsps(parallel) / (numChains * getMsps(single))) : 0.0;
+
+        result["parallel"] = parallelResult;
+    }
+
+    return result;
+}
+
+static std::string runBenchmarks(
+    const std::string& pathPrefix,
+    size_t numElements,
+    size_t numChains)
+{
+    nlohmann::json results = nlohmann::json::array();
+
+    for(const auto& benchmarkableBlock: findBenchmarkableBlocks(pathPrefix))
+    {
+        for(const auto& type: benchmarkableBlock.types)
+        {
+            const Pothos::DType dtype(type);
+
+            for(size_t bufferSize: BufferSizes)
+            {
+                try
+                {
+                    results.push_back(benchmarkBlock(benchmarkableBlock, dtype, bufferSize, numElements, numChains));
+                }
+                catch(const std::exception& ex)
+                {
+                    nlohmann::json result;
+                    result["path"] = benchmarkableBlock.path;
+                    result["dtype"] = dtype.name();
+                    result["bufferSize"] = bufferSize;
+                    result["error"] = ex.what();
+
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    nlohmann::json output;
+    output["numElements"] = numElements;
+    output["numChains"] = numChains;
+    output["bufferSizes"] = BufferSizes;
+    output["results"] = results;
+
+    return output.dump();
+}
+
+pothos_static_block(registerBenchmark)
+{
+    Pothos::PluginRegistry::addCall(
+        "/numpy/benchmark/run",
+        Pothos::Callable(runBenchmarks));
+}
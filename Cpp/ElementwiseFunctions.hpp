@@ -0,0 +1,509 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/Utility.hpp"
+
+#include <cmath>
+#include <complex>
+#include <type_traits>
+
+//
+// Native equivalents of NumPy's elementwise functions. Each functor is named
+// after the "name" field of its YAML entry, which is how the generated factory
+// finds it, and exposes its input and output types so the block templates can
+// set up their ports.
+//
+// These should match NumPy's output for every type in the corresponding YAML
+// entry's blockType list.
+//
+
+namespace PothosNumPy
+{
+
+namespace detail
+{
+    // std::complex doesn't provide these, so use the same identities NumPy does.
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> expm1(const T& x)
+    {
+        return std::expm1(x);
+    }
+
+    template <typename T>
+    static inline EnableIfComplex<T, T> expm1(const T& x)
+    {
+        return std::exp(x) - T(1);
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> exp2(const T& x)
+    {
+        return std::exp2(x);
+    }
+
+    template <typename T>
+    static inline EnableIfComplex<T, T> exp2(const T& x)
+    {
+        return std::pow(T(2), x);
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> log2(const T& x)
+    {
+        return std::log2(x);
+    }
+
+    template <typename T>
+    static inline EnableIfComplex<T, T> log2(const T& x)
+    {
+        using Scalar = typename T::value_type;
+
+        return std::log(x) / std::log(Scalar(2));
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> log1p(const T& x)
+    {
+        return std::log1p(x);
+    }
+
+    template <typename T>
+    static inline EnableIfComplex<T, T> log1p(const T& x)
+    {
+        return std::log(T(1) + x);
+    }
+
+    // With the default rounding mode, this rounds halfway values to the
+    // nearest even value, like numpy.rint.
+    template <typename T>
+    static inline EnableIfFloat<T, T> rint(const T& x)
+    {
+        return std::nearbyint(x);
+    }
+
+    template <typename T>
+    static inline EnableIfComplex<T, T> rint(const T& x)
+    {
+        return T(std::nearbyint(x.real()), std::nearbyint(x.imag()));
+    }
+
+    //
+    // Binary functions
+    //
+
+    // NumPy integer arithmetic wraps around, but signed overflow is undefined
+    // in C++, and small unsigned types are promoted to int, so do the math in
+    // an unsigned type at least as wide as unsigned int.
+    template <typename T>
+    using WrapType = typename std::common_type<typename std::make_unsigned<T>::type, unsigned int>::type;
+
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> add(const T& x, const T& y)
+    {
+        return T(WrapType<T>(x) + WrapType<T>(y));
+    }
+
+    template <typename T>
+    static inline EnableIfNotInt<T, T> add(const T& x, const T& y)
+    {
+        return x + y;
+    }
+
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> subtract(const T& x, const T& y)
+    {
+        return T(WrapType<T>(x) - WrapType<T>(y));
+    }
+
+    template <typename T>
+    static inline EnableIfNotInt<T, T> subtract(const T& x, const T& y)
+    {
+        return x - y;
+    }
+
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> multiply(const T& x, const T& y)
+    {
+        return T(WrapType<T>(x) * WrapType<T>(y));
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> multiply(const T& x, const T& y)
+    {
+        return x * y;
+    }
+
+    // See the comment on the complex multiply kernel in Kernels.hpp.
+    template <typename T>
+    static inline EnableIfComplex<T, T> multiply(const T& x, const T& y)
+    {
+        return T((x.real()*y.real()) - (x.imag()*y.imag()),
+                 (x.real()*y.imag()) + (x.imag()*y.real()));
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> divide(const T& x, const T& y)
+    {
+        return x / y;
+    }
+
+    // Smith's algorithm, as used by NumPy
+    template <typename T>
+    static inline EnableIfComplex<T, T> divide(const T& x, const T& y)
+    {
+        using Scalar = typename T::value_type;
+
+        const Scalar absYReal = std::fabs(y.real());
+        const Scalar absYImag = std::fabs(y.imag());
+
+        if(absYReal >= absYImag)
+        {
+            if((absYReal == Scalar(0)) && (absYImag == Scalar(0)))
+            {
+                return T(x.real() / absYReal, x.imag() / absYImag);
+            }
+
+            const Scalar rat = y.imag() / y.real();
+            const Scalar scl = Scalar(1) / (y.real() + (y.imag() * rat));
+
+            return T(((x.imag() * rat) + x.real()) * scl,
+                     (x.imag() - (x.real() * rat)) * scl);
+        }
+        else
+        {
+            const Scalar rat = y.real() / y.imag();
+            const Scalar scl = Scalar(1) / (y.imag() + (y.real() * rat));
+
+            return T(((x.real() * rat) + x.imag()) * scl,
+                     ((x.imag() * rat) - x.real()) * scl);
+        }
+    }
+
+    // Python-style floor division and remainder, matching npy_divmod
+    template <typename T>
+    static inline EnableIfFloat<T, T> floorDivide(const T& x, const T& y)
+    {
+        if(y == T(0)) return x / y;
+
+        T mod = std::fmod(x, y);
+        T div = (x - mod) / y;
+        if(mod != T(0))
+        {
+            if(std::isless(y, T(0)) != std::isless(mod, T(0))) div -= T(1);
+        }
+
+        if(div == T(0)) return std::copysign(T(0), x / y);
+
+        T floorDiv = std::floor(div);
+        if(std::isgreater(div - floorDiv, T(0.5))) floorDiv += T(1);
+
+        return floorDiv;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> remainder(const T& x, const T& y)
+    {
+        T mod = std::fmod(x, y);
+        if(y == T(0)) return mod;
+
+        if(mod != T(0))
+        {
+            if(std::isless(y, T(0)) != std::isless(mod, T(0))) mod += y;
+        }
+        else mod = std::copysign(T(0), y);
+
+        return mod;
+    }
+
+    // NumPy returns 0 for integer division by zero rather than raising.
+    // Dividing the minimum value by -1 would overflow, but the remainder is
+    // always 0.
+    template <typename T>
+    static inline EnableIfInteger<T, T> remainder(const T& x, const T& y)
+    {
+        if((y == T(0)) || (y == T(-1))) return T(0);
+
+        T mod = x % y;
+        if((mod != T(0)) && ((mod < T(0)) != (y < T(0)))) mod += y;
+
+        return mod;
+    }
+
+    template <typename T>
+    static inline EnableIfUnsignedInt<T, T> remainder(const T& x, const T& y)
+    {
+        return (y == T(0)) ? T(0) : T(x % y);
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> fmod(const T& x, const T& y)
+    {
+        return std::fmod(x, y);
+    }
+
+    template <typename T>
+    static inline EnableIfInteger<T, T> fmod(const T& x, const T& y)
+    {
+        return ((y == T(0)) || (y == T(-1))) ? T(0) : T(x % y);
+    }
+
+    template <typename T>
+    static inline EnableIfUnsignedInt<T, T> fmod(const T& x, const T& y)
+    {
+        return (y == T(0)) ? T(0) : T(x % y);
+    }
+
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> negative(const T& x)
+    {
+        return T(WrapType<T>(0) - WrapType<T>(x));
+    }
+
+    template <typename T>
+    static inline EnableIfNotInt<T, T> negative(const T& x)
+    {
+        return -x;
+    }
+
+    // Like NumPy, the minimum value is its own absolute value, since the
+    // result can't be represented.
+    template <typename T>
+    static inline EnableIfInteger<T, T> absolute(const T& x)
+    {
+        return (x < T(0)) ? negative(x) : x;
+    }
+
+    template <typename T>
+    static inline EnableIfUnsignedInt<T, T> absolute(const T& x)
+    {
+        return x;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> absolute(const T& x)
+    {
+        return std::abs(x);
+    }
+
+    // NumPy computes this in floating-point for integers, which can't be
+    // represented when the magnitude of the minimum value is cast back.
+    // Here, it wraps to itself, so copysign(-128, 1) is -128 for int8.
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> copysign(const T& x, const T& y)
+    {
+        const T absX = (x < T(0)) ? negative(x) : x;
+
+        return (y < T(0)) ? negative(absX) : absX;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> copysign(const T& x, const T& y)
+    {
+        return std::copysign(x, y);
+    }
+
+    // numpy.sinc substitutes a tiny value for 0, which gives the limit of 1.
+    template <typename T>
+    static inline EnableIfFloat<T, T> sinc(const T& x)
+    {
+        if(x == T(0)) return T(1);
+
+        const T y = T(M_PI) * x;
+        return std::sin(y) / y;
+    }
+
+    // Like NumPy, propagate NaNs.
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> maximum(const T& x, const T& y)
+    {
+        return (x >= y) ? x : y;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> maximum(const T& x, const T& y)
+    {
+        return ((x >= y) || std::isnan(x)) ? x : y;
+    }
+
+    template <typename T>
+    static inline EnableIfAnyInt<T, T> minimum(const T& x, const T& y)
+    {
+        return (x <= y) ? x : y;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> minimum(const T& x, const T& y)
+    {
+        return ((x <= y) || std::isnan(x)) ? x : y;
+    }
+
+    // Matches npy_logaddexp and npy_logaddexp2
+    template <typename T>
+    static inline EnableIfFloat<T, T> logaddexp(const T& x, const T& y)
+    {
+        // Handles infinities of the same sign
+        if(x == y) return x + T(M_LN2);
+
+        const T diff = x - y;
+        if(diff > T(0)) return x + std::log1p(std::exp(-diff));
+        else if(diff <= T(0)) return y + std::log1p(std::exp(diff));
+
+        // NaN
+        return diff;
+    }
+
+    template <typename T>
+    static inline EnableIfFloat<T, T> logaddexp2(const T& x, const T& y)
+    {
+        // Handles infinities of the same sign
+        if(x == y) return x + T(1);
+
+        const T diff = x - y;
+        if(diff > T(0)) return x + (T(M_LOG2E) * std::log1p(std::exp2(-diff)));
+        else if(diff <= T(0)) return y + (T(M_LOG2E) * std::log1p(std::exp2(diff)));
+
+        // NaN
+        return diff;
+    }
+}
+
+#define POTHOS_NUMPY_UNARY_FUNCTOR(name, expr) \
+    template <typename T> \
+    struct name \
+    { \
+        using InType = T; \
+        using OutType = T; \
+ \
+        static inline OutType apply(const InType& x) \
+        { \
+            return OutType(expr); \
+        } \
+    };
+
+#define POTHOS_NUMPY_COMPLEX_TO_SCALAR_FUNCTOR(name, expr) \
+    template <typename T> \
+    struct name \
+    { \
+        using InType = T; \
+        using OutType = typename T::value_type; \
+ \
+        static inline OutType apply(const InType& x) \
+        { \
+            return OutType(expr); \
+        } \
+    };
+
+#define POTHOS_NUMPY_BINARY_FUNCTOR(name, expr) \
+    template <typename T> \
+    struct name \
+    { \
+        using InType = T; \
+        using OutType = T; \
+ \
+        static inline OutType apply(const InType& x, const InType& y) \
+        { \
+            return OutType(expr); \
+        } \
+    };
+
+//
+// Arithmetic
+//
+
+POTHOS_NUMPY_BINARY_FUNCTOR(Add,         detail::add(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Multiply,    detail::multiply(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Subtract,    detail::subtract(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Divide,      detail::divide(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(TrueDivide,  detail::divide(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(FloorDivide, detail::floorDivide(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Mod,         detail::remainder(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(FMod,        detail::fmod(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Maximum,     detail::maximum(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(Minimum,     detail::minimum(x, y))
+
+POTHOS_NUMPY_UNARY_FUNCTOR(Reciprocal, T(1) / x)
+POTHOS_NUMPY_UNARY_FUNCTOR(SqRt,       std::sqrt(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(CbRt,       std::cbrt(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Square,     detail::multiply(x, x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Absolute,   detail::absolute(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(FAbs,       std::fabs(x))
+
+//
+// Binary
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(Invert,      ~x)
+POTHOS_NUMPY_BINARY_FUNCTOR(BitwiseAnd, x & y)
+POTHOS_NUMPY_BINARY_FUNCTOR(BitwiseOr,  x | y)
+POTHOS_NUMPY_BINARY_FUNCTOR(BitwiseXor, x ^ y)
+
+//
+// Trigonometric
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(Sin,     std::sin(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Cos,     std::cos(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Tan,     std::tan(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcSin,  std::asin(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcCos,  std::acos(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcTan,  std::atan(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(SinH,    std::sinh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(CosH,    std::cosh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(TanH,    std::tanh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcSinH, std::asinh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcCosH, std::acosh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ArcTanH, std::atanh(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Deg2Rad, x * T(M_PI / 180.0))
+POTHOS_NUMPY_UNARY_FUNCTOR(Rad2Deg, x * T(180.0 / M_PI))
+
+//
+// Complex
+//
+
+POTHOS_NUMPY_COMPLEX_TO_SCALAR_FUNCTOR(Angle, std::arg(x))
+POTHOS_NUMPY_COMPLEX_TO_SCALAR_FUNCTOR(Real,  x.real())
+POTHOS_NUMPY_COMPLEX_TO_SCALAR_FUNCTOR(Imag,  x.imag())
+POTHOS_NUMPY_UNARY_FUNCTOR(Conjugate,         std::conj(x))
+
+//
+// Special
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(NormalizedSinc, detail::sinc(x))
+
+//
+// Stream
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(Positive,    x)
+POTHOS_NUMPY_UNARY_FUNCTOR(Negative,    detail::negative(x))
+POTHOS_NUMPY_BINARY_FUNCTOR(CopySign,   detail::copysign(x, y))
+
+//
+// Exponential
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(Exp,   std::exp(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(ExpM1, detail::expm1(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Exp2,  detail::exp2(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Log,   std::log(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Log10, std::log10(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Log2,  detail::log2(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Log1P, detail::log1p(x))
+
+POTHOS_NUMPY_BINARY_FUNCTOR(LogAddExp,  detail::logaddexp(x, y))
+POTHOS_NUMPY_BINARY_FUNCTOR(LogAddExp2, detail::logaddexp2(x, y))
+
+//
+// Rounding
+//
+
+POTHOS_NUMPY_UNARY_FUNCTOR(RInt,  detail::rint(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Ceil,  std::ceil(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Floor, std::floor(x))
+POTHOS_NUMPY_UNARY_FUNCTOR(Trunc, std::trunc(x))
+
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/Expression.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+//
+// Evaluates an arithmetic expression over all inputs in a single pass,
+// replacing a chain of arithmetic blocks and the intermediate buffers
+// between them.
+//
+
+template <typename T>
+class ExprBlock: public PothosNumPy::BaseBlock
+{
+    public:
+        ExprBlock(const size_t nchans, const std::string& expression):
+            PothosNumPy::BaseBlock("/numpy/expr"),
+            _inputPtrs(nchans)
+        {
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(ExprBlock, numChannels));
+            this->registerCall(this, POTHOS_FCN_TUPLE(ExprBlock, expression));
+            this->registerCall(this, POTHOS_FCN_TUPLE(ExprBlock, setExpression));
+            this->registerProbe("expression");
+
+            this->setExpression(expression);
+
+            for(size_t chan = 0; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, Pothos::DType(typeid(T)));
+            }
+            this->setupOutput(0, Pothos::DType(typeid(T)));
+        }
+
+        virtual ~ExprBlock() = default;
+
+        size_t numChannels() const
+        {
+            return _inputPtrs.size();
+        }
+
+        std::string expression() const
+        {
+            return _expression->expression();
+        }
+
+        // Compiling the expression here means an invalid expression is
+        // reported when it's set instead of in work().
+        void setExpression(const std::string& expression)
+        {
+            _expression.reset(new PothosNumPy::Expression<T>(expression, _inputPtrs.size()));
+        }
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllElements;
+            if(!this->countWork(elems)) return;
+
+            const auto& inputs = this->inputs();
+            for(size_t chan = 0; chan < inputs.size(); ++chan)
+            {
+                _inputPtrs[chan] = inputs[chan]->buffer();
+            }
+
+            auto output = this->output(0);
+            this->timeFunc([&]()
+            {
+                _expression->evaluate(_inputPtrs.data(), output->buffer(), elems);
+            });
+
+            for(auto* input: inputs) input->consume(elems);
+            output->produce(elems);
+            this->countElements(elems, elems);
+        }
+
+    private:
+        std::unique_ptr<PothosNumPy::Expression<T>> _expression;
+        std::vector<const T*> _inputPtrs;
+};
+
+/***********************************************************************
+ * |PothosDoc Expression (NumPy)
+ *
+ * Evaluate an arithmetic expression over all inputs, element-wise.
+ *
+ * The expression is compiled once, and all of its operations are applied to
+ * each cache-sized chunk of input in a single pass. This is equivalent to a
+ * chain of arithmetic blocks, without the memory traffic of passing
+ * intermediate buffers between them.
+ *
+ * Inputs are named <b>in0</b>, <b>in1</b>, etc. Expressions support the
+ * <b>+ - * / **</b> operators with Python's precedence, parentheses, numeric
+ * constants, and the constants <b>pi</b> and <b>e</b>. For complex types,
+ * imaginary constants are written as in Python, such as <b>2j</b>.
+ *
+ * Supported functions, with the same names as their NumPy equivalents:
+ * <ul>
+ * <li><b>sin, cos, tan, arcsin, arccos, arctan</b></li>
+ * <li><b>sinh, cosh, tanh, arcsinh, arccosh, arctanh</b></li>
+ * <li><b>exp, log, log10, sqrt, square, power(x, y)</b></li>
+ * <li>Floating-point types only: <b>absolute, abs, floor, ceil, arctan2(y, x), hypot(x, y), maximum(x, y), minimum(x, y)</b></li>
+ * <li>Complex types only: <b>conjugate, conj</b></li>
+ * </ul>
+ *
+ * Example: <b>in0*in1 + 2*in2</b>
+ *
+ * |category /NumPy/Arithmetic
+ * |category /Math/NumPy
+ * |keywords expression fused arithmetic numexpr
+ * |factory /numpy/expr(dtype,nchans,expression)
+ * |setter setExpression(expression)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Inputs] The number of input ports.
+ * |widget SpinBox(minimum=1)
+ * |default 2
+ * |preview disable
+ *
+ * |param expression[Expression] The expression to evaluate for each element.
+ * |widget StringEntry()
+ * |default "in0*in1"
+ * |preview enable
+ **********************************************************************/
+static Pothos::Block* makeExprBlock(
+    const Pothos::DType& dtype,
+    const size_t nchans,
+    const std::string& expression)
+{
+    #define ifTypeDeclareFactory(T) \
+        if(Pothos::DType::fromDType(dtype, 1) == Pothos::DType(typeid(T))) \
+            return new ExprBlock<T>(nchans, expression);
+
+    ifTypeDeclareFactory(float)
+    ifTypeDeclareFactory(double)
+    ifTypeDeclareFactory(std::complex<float>)
+    ifTypeDeclareFactory(std::complex<double>)
+    #undef ifTypeDeclareFactory
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+static Pothos::BlockRegistry registerNumPyExpr(
+    "/numpy/expr",
+    Pothos::Callable(&makeExprBlock));
@@ -0,0 +1,599 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// An elementwise arithmetic expression over a block's inputs, compiled once
+// into a list of stack machine instructions. Each instruction is applied to
+// a cache-sized chunk of elements at a time, so intermediate values stay in
+// cache instead of round-tripping through memory like separate blocks do.
+//
+// Grammar, matching Python's precedence:
+//   expr    := term (('+' | '-') term)*
+//   term    := unary (('*' | '/') unary)*
+//   unary   := ('+' | '-') unary | power
+//   power   := primary ('**' unary)?
+//   primary := number | constant | input | function '(' args ')' | '(' expr ')'
+//
+// Inputs are named in0, in1, etc. Constants are pi and e, and complex types
+// also accept imaginary literals, such as 2j. Functions use their NumPy names.
+//
+
+template <typename T>
+class Expression
+{
+    public:
+        using UnaryFcn = T(*)(T);
+        using BinaryFcn = T(*)(T, T);
+
+        // Elements processed per instruction. Each stack slot is this many
+        // elements, so the working set for typical expressions fits in L1.
+        static constexpr size_t ChunkSize = 512;
+
+        Expression(const std::string& expression, const size_t numInputs):
+            _expression(expression),
+            _numInputs(numInputs),
+            _maxDepth(0)
+        {
+            Parser parser(*this);
+            parser.parse();
+
+            // The bottom of the stack is the output buffer itself.
+            _scratch.resize((_maxDepth - 1) * ChunkSize);
+            _stack.reserve(_maxDepth);
+        }
+
+        const std::string& expression() const
+        {
+            return _expression;
+        }
+
+        size_t numInputs() const
+        {
+            return _numInputs;
+        }
+
+        void evaluate(
+            const T* const* inputs,
+            T* out,
+            const size_t numElems)
+        {
+            for(size_t offset = 0; offset < numElems; offset += ChunkSize)
+            {
+                this->evaluateChunk(
+                    inputs,
+                    offset,
+                    out + offset,
+                    std::min(ChunkSize, numElems - offset));
+            }
+        }
+
+    private:
+        enum class OpCode
+        {
+            PushInput,
+            PushConstant,
+            Negate,
+            Add,
+            Subtract,
+            Multiply,
+            Divide,
+            Power,
+            UnaryFunction,
+            BinaryFunction
+        };
+
+        struct Instruction
+        {
+            OpCode op;
+            size_t inputIndex;
+            T constant;
+            UnaryFcn unaryFcn;
+            BinaryFcn binaryFcn;
+        };
+
+        // A stack entry is either a chunk of elements or a scalar constant.
+        struct Value
+        {
+            const T* data;
+            T scalar;
+            bool isScalar;
+        };
+
+        std::string _expression;
+        size_t _numInputs;
+        std::vector<Instruction> _instructions;
+        size_t _maxDepth;
+
+        std::vector<T> _scratch;
+        std::vector<Value> _stack;
+
+        //
+        // Compilation
+        //
+
+        class Parser
+        {
+            public:
+                Parser(Expression& expression):
+                    _expr(expression),
+                    _str(expression._expression),
+                    _pos(0),
+                    _depth(0)
+                {}
+
+                void parse()
+                {
+                    this->parseExpr();
+
+                    this->skipSpaces();
+                    if(_pos != _str.size()) this->throwError("Unexpected character");
+                }
+
+            private:
+                Expression& _expr;
+                const std::string& _str;
+                size_t _pos;
+                size_t _depth;
+
+                void throwError(const std::string& message) const
+                {
+                    throw Pothos::InvalidArgumentException(
+                              "Invalid expression \""+_str+"\"",
+                              message+" at position "+std::to_string(_pos));
+                }
+
+                void skipSpaces()
+                {
+                    while((_pos < _str.size()) && std::isspace(static_cast<unsigned char>(_str[_pos]))) ++_pos;
+                }
+
+                bool accept(const std::string& token)
+                {
+                    this->skipSpaces();
+                    if(0 == _str.compare(_pos, token.size(), token))
+                    {
+                        // Don't mistake the ** operator for *.
+                        if((token == "*") && (0 == _str.compare(_pos, 2, "**"))) return false;
+
+                        _pos += token.size();
+                        return true;
+                    }
+
+                    return false;
+                }
+
+                void expect(const std::string& token)
+                {
+                    if(!this->accept(token)) this->throwError("Expected \""+token+"\"");
+                }
+
+                void emit(const Instruction& instruction)
+                {
+                    switch(instruction.op)
+                    {
+                    case OpCode::PushInput:
+                    case OpCode::PushConstant:
+                        ++_depth;
+                        break;
+
+                    case OpCode::Add:
+                    case OpCode::Subtract:
+                    case OpCode::Multiply:
+                    case OpCode::Divide:
+                    case OpCode::Power:
+                    case OpCode::BinaryFunction:
+                        --_depth;
+                        break;
+
+                    default:
+                        break;
+                    }
+
+                    _expr._maxDepth = std::max(_expr._maxDepth, _depth);
+                    _expr._instructions.emplace_back(instruction);
+                }
+
+                void emitOp(const OpCode op)
+                {
+                    this->emit(Instruction{op, 0, T(0), nullptr, nullptr});
+                }
+
+                void emitConstant(const T& constant)
+                {
+                    this->emit(Instruction{OpCode::PushConstant, 0, constant, nullptr, nullptr});
+                }
+
+                void parseExpr()
+                {
+                    this->parseTerm();
+                    while(true)
+                    {
+                        if(this->accept("+"))
+                        {
+                            this->parseTerm();
+                            this->emitOp(OpCode::Add);
+                        }
+                        else if(this->accept("-"))
+                        {
+                            this->parseTerm();
+                            this->emitOp(OpCode::Subtract);
+                        }
+                        else break;
+                    }
+                }
+
+                void parseTerm()
+                {
+                    this->parseUnary();
+                    while(true)
+                    {
+                        if(this->accept("*"))
+                        {
+                            this->parseUnary();
+                            this->emitOp(OpCode::Multiply);
+                        }
+                        else if(this->accept("/"))
+                        {
+                            this->parseUnary();
+                            this->emitOp(OpCode::Divide);
+                        }
+                        else break;
+                    }
+                }
+
+                void parseUnary()
+                {
+                    if(this->accept("-"))
+                    {
+                        this->parseUnary();
+                        this->emitOp(OpCode::Negate);
+                    }
+                    else if(this->accept("+")) this->parseUnary();
+                    else this->parsePower();
+                }
+
+                void parsePower()
+                {
+                    this->parsePrimary();
+                    if(this->accept("**"))
+                    {
+                        // Right-associative, and binds tighter than a unary
+                        // minus on its left: -x**2 == -(x**2)
+                        this->parseUnary();
+                        this->emitOp(OpCode::Power);
+                    }
+                }
+
+                void parsePrimary()
+                {
+                    this->skipSpaces();
+                    if(_pos >= _str.size()) this->throwError("Unexpected end of expression");
+
+                    const char c = _str[_pos];
+                    if(this->accept("("))
+                    {
+                        this->parseExpr();
+                        this->expect(")");
+                    }
+                    else if(std::isdigit(static_cast<unsigned char>(c)) || (c == '.')) this->parseNumber();
+                    else if(std::isalpha(static_cast<unsigned char>(c)) || (c == '_')) this->parseIdentifier();
+                    else this->throwError("Unexpected character");
+                }
+
+                void parseNumber()
+                {
+                    const char* begin = _str.c_str() + _pos;
+                    char* end = nullptr;
+                    const double value = std::strtod(begin, &end);
+                    if(end == begin) this->throwError("Invalid number");
+                    _pos += (end - begin);
+
+                    if((_pos < _str.size()) && ((_str[_pos] == 'j') || (_str[_pos] == 'J')))
+                    {
+                        ++_pos;
+                        this->emitConstant(makeImaginary(value));
+                    }
+                    else this->emitConstant(T(value));
+                }
+
+                void parseIdentifier()
+                {
+                    const size_t start = _pos;
+                    while((_pos < _str.size()) && (std::isalnum(static_cast<unsigned char>(_str[_pos])) || (_str[_pos] == '_'))) ++_pos;
+                    const auto name = _str.substr(start, _pos-start);
+
+                    static const auto& unaryFunctions = getUnaryFunctions();
+                    static const auto& binaryFunctions = getBinaryFunctions();
+
+                    const auto unaryIter = unaryFunctions.find(name);
+                    const auto binaryIter = binaryFunctions.find(name);
+
+                    if(unaryIter != unaryFunctions.end())
+                    {
+                        this->expect("(");
+                        this->parseExpr();
+                        this->expect(")");
+
+                        this->emit(Instruction{OpCode::UnaryFunction, 0, T(0), unaryIter->second, nullptr});
+                    }
+                    else if(binaryIter != binaryFunctions.end())
+                    {
+                        this->expect("(");
+                        this->parseExpr();
+                        this->expect(",");
+                        this->parseExpr();
+                        this->expect(")");
+
+                        this->emit(Instruction{OpCode::BinaryFunction, 0, T(0), nullptr, binaryIter->second});
+                    }
+                    else if(name == "pi") this->emitConstant(T(3.141592653589793238462643383279502884));
+                    else if(name == "e")  this->emitConstant(T(2.718281828459045235360287471352662498));
+                    else if((name.size() > 2) && (0 == name.compare(0, 2, "in")) &&
+                            std::all_of(name.begin()+2, name.end(), [](char c){return std::isdigit(static_cast<unsigned char>(c));}))
+                    {
+                        const size_t index = std::stoul(name.substr(2));
+                        if(index >= _expr._numInputs)
+                        {
+                            _pos = start;
+                            this->throwError("Input "+name+" does not exist");
+                        }
+
+                        this->emit(Instruction{OpCode::PushInput, index, T(0), nullptr, nullptr});
+                    }
+                    else
+                    {
+                        _pos = start;
+                        this->throwError("Unknown name \""+name+"\"");
+                    }
+                }
+        };
+
+        template <typename U = T>
+        static EnableIfComplex<U, U> makeImaginary(const double value)
+        {
+            return U(0, value);
+        }
+
+        template <typename U = T>
+        static EnableIfNotComplex<U, U> makeImaginary(const double)
+        {
+            throw Pothos::InvalidArgumentException("Imaginary constants require a complex type.");
+        }
+
+        // Functions that accept and return both real and complex values
+        static std::unordered_map<std::string, UnaryFcn> getCommonUnaryFunctions()
+        {
+            return
+            {
+                {"sin",     [](T x) -> T {return std::sin(x);}},
+                {"cos",     [](T x) -> T {return std::cos(x);}},
+                {"tan",     [](T x) -> T {return std::tan(x);}},
+                {"arcsin",  [](T x) -> T {return std::asin(x);}},
+                {"arccos",  [](T x) -> T {return std::acos(x);}},
+                {"arctan",  [](T x) -> T {return std::atan(x);}},
+                {"sinh",    [](T x) -> T {return std::sinh(x);}},
+                {"cosh",    [](T x) -> T {return std::cosh(x);}},
+                {"tanh",    [](T x) -> T {return std::tanh(x);}},
+                {"arcsinh", [](T x) -> T {return std::asinh(x);}},
+                {"arccosh", [](T x) -> T {return std::acosh(x);}},
+                {"arctanh", [](T x) -> T {return std::atanh(x);}},
+                {"exp",     [](T x) -> T {return std::exp(x);}},
+                {"log",     [](T x) -> T {return std::log(x);}},
+                {"log10",   [](T x) -> T {return std::log10(x);}},
+                {"sqrt",    [](T x) -> T {return std::sqrt(x);}},
+                {"square",  [](T x) -> T {return x*x;}},
+            };
+        }
+
+        template <typename U = T>
+        static EnableIfFloat<U, const std::unordered_map<std::string, UnaryFcn>&> getUnaryFunctions()
+        {
+            static const auto functions = []()
+            {
+                auto functions = getCommonUnaryFunctions();
+                functions.emplace("absolute", [](T x) -> T {return std::abs(x);});
+                functions.emplace("abs",      [](T x) -> T {return std::abs(x);});
+                functions.emplace("floor",    [](T x) -> T {return std::floor(x);});
+                functions.emplace("ceil",     [](T x) -> T {return std::ceil(x);});
+
+                return functions;
+            }();
+
+            return functions;
+        }
+
+        template <typename U = T>
+        static EnableIfComplex<U, const std::unordered_map<std::string, UnaryFcn>&> getUnaryFunctions()
+        {
+            static const auto functions = []()
+            {
+                auto functions = getCommonUnaryFunctions();
+                functions.emplace("conjugate", [](T x) -> T {return std::conj(x);});
+                functions.emplace("conj",      [](T x) -> T {return std::conj(x);});
+
+                return functions;
+            }();
+
+            return functions;
+        }
+
+        template <typename U = T>
+        static EnableIfFloat<U, const std::unordered_map<std::string, BinaryFcn>&> getBinaryFunctions()
+        {
+            // Like NumPy, maximum and minimum propagate NaNs.
+            static const std::unordered_map<std::string, BinaryFcn> functions =
+            {
+                {"power",   [](T x, T y) -> T {return std::pow(x, y);}},
+                {"arctan2", [](T x, T y) -> T {return std::atan2(x, y);}},
+                {"hypot",   [](T x, T y) -> T {return std::hypot(x, y);}},
+                {"maximum", [](T x, T y) -> T {return (std::isnan(x) || (x > y)) ? x : y;}},
+                {"minimum", [](T x, T y) -> T {return (std::isnan(x) || (x < y)) ? x : y;}},
+            };
+
+            return functions;
+        }
+
+        template <typename U = T>
+        static EnableIfComplex<U, const std::unordered_map<std::string, BinaryFcn>&> getBinaryFunctions()
+        {
+            static const std::unordered_map<std::string, BinaryFcn> functions =
+            {
+                {"power", [](T x, T y) -> T {return std::pow(x, y);}},
+            };
+
+            return functions;
+        }
+
+        //
+        // Evaluation
+        //
+
+        template <typename Op>
+        static Value applyUnary(const Value& x, T* dst, const size_t numElems, Op op)
+        {
+            if(x.isScalar) return Value{nullptr, op(x.scalar), true};
+
+            for(size_t elem = 0; elem < numElems; ++elem) dst[elem] = op(x.data[elem]);
+
+            return Value{dst, T(0), false};
+        }
+
+        // Separate loops for each operand combination keep the inner loops
+        // branch-free so they can be vectorized.
+        template <typename Op>
+        static Value applyBinary(const Value& x, const Value& y, T* dst, const size_t numElems, Op op)
+        {
+            if(x.isScalar && y.isScalar) return Value{nullptr, op(x.scalar, y.scalar), true};
+            else if(x.isScalar)
+            {
+                const T xs = x.scalar;
+                const T* yd = y.data;
+                for(size_t elem = 0; elem < numElems; ++elem) dst[elem] = op(xs, yd[elem]);
+            }
+            else if(y.isScalar)
+            {
+                const T* xd = x.data;
+                const T ys = y.scalar;
+                for(size_t elem = 0; elem < numElems; ++elem) dst[elem] = op(xd[elem], ys);
+            }
+            else
+            {
+                const T* xd = x.data;
+                const T* yd = y.data;
+                for(size_t elem = 0; elem < numElems; ++elem) dst[elem] = op(xd[elem], yd[elem]);
+            }
+
+            return Value{dst, T(0), false};
+        }
+
+        void evaluateChunk(
+            const T* const* inputs,
+            const size_t offset,
+            T* out,
+            const size_t numElems)
+        {
+            // The result at each stack depth is written to the same slot, so
+            // once an operand is popped, its storage can be reused.
+            const auto getSlot = [&](const size_t depth) -> T*
+            {
+                return (0 == depth) ? out : (_scratch.data() + ((depth-1) * ChunkSize));
+            };
+
+            _stack.clear();
+            for(const auto& instruction: _instructions)
+            {
+                if(OpCode::PushInput == instruction.op)
+                {
+                    _stack.emplace_back(Value{inputs[instruction.inputIndex] + offset, T(0), false});
+                    continue;
+                }
+                else if(OpCode::PushConstant == instruction.op)
+                {
+                    _stack.emplace_back(Value{nullptr, instruction.constant, true});
+                    continue;
+                }
+                else if(OpCode::Negate == instruction.op)
+                {
+                    auto& x = _stack.back();
+                    x = applyUnary(x, getSlot(_stack.size()-1), numElems, [](T a){return -a;});
+                    continue;
+                }
+                else if(OpCode::UnaryFunction == instruction.op)
+                {
+                    auto& x = _stack.back();
+                    x = applyUnary(x, getSlot(_stack.size()-1), numElems, instruction.unaryFcn);
+                    continue;
+                }
+
+                const Value y = _stack.back();
+                _stack.pop_back();
+                auto& x = _stack.back();
+                T* dst = getSlot(_stack.size()-1);
+
+                switch(instruction.op)
+                {
+                case OpCode::Add:
+                    x = applyBinary(x, y, dst, numElems, [](T a, T b){return a+b;});
+                    break;
+
+                case OpCode::Subtract:
+                    x = applyBinary(x, y, dst, numElems, [](T a, T b){return a-b;});
+                    break;
+
+                case OpCode::Multiply:
+                    x = applyBinary(x, y, dst, numElems, [](T a, T b){return a*b;});
+                    break;
+
+                case OpCode::Divide:
+                    x = applyBinary(x, y, dst, numElems, [](T a, T b){return a/b;});
+                    break;
+
+                case OpCode::Power:
+                    // Squaring is common enough to avoid the general case, and
+                    // NumPy special-cases it the same way.
+                    if(y.isScalar && (y.scalar == T(2)))
+                    {
+                        x = applyUnary(x, dst, numElems, [](T a){return a*a;});
+                    }
+                    else x = applyBinary(x, y, dst, numElems, [](T a, T b) -> T {return std::pow(a, b);});
+                    break;
+
+                case OpCode::BinaryFunction:
+                    x = applyBinary(x, y, dst, numElems, instruction.binaryFcn);
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            // The result is already in the output buffer unless the whole
+            // expression was a single input or constant.
+            const auto& result = _stack.back();
+            if(result.isScalar) std::fill(out, out+numElems, result.scalar);
+            else if(result.data != out) std::copy(result.data, result.data+numElems, out);
+        }
+};
+
+template <typename T>
+constexpr size_t Expression<T>::ChunkSize;
+
+}
@@ -0,0 +1,404 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <Pothos/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// FFT engine used by the /numpy/fft/* blocks. Plans hold everything that
+// depends only on the transform size (twiddle factors, permutation tables,
+// Bluestein chirps), so they are computed once per size and shared between
+// blocks. Plans are immutable, so each caller provides its own workspace.
+//
+// Powers of two use an iterative radix-2 transform. Other sizes use
+// Bluestein's algorithm on top of a power-of-two transform, which is slower
+// but still O(n log n).
+//
+
+namespace detail
+{
+    // std::complex's operator* handles infinities and NaNs specially, which
+    // keeps it from being inlined in the butterfly loops.
+    template <typename T>
+    static inline std::complex<T> complexMultiply(const std::complex<T>& x, const std::complex<T>& y)
+    {
+        return std::complex<T>(
+                   (x.real()*y.real()) - (x.imag()*y.imag()),
+                   (x.real()*y.imag()) + (x.imag()*y.real()));
+    }
+
+    // Computed in double precision, regardless of T, so float32 transforms
+    // don't accumulate error from their twiddles.
+    template <typename T>
+    static inline std::complex<T> unitPhasor(const double numerator, const double denominator)
+    {
+        static const double Pi = 3.141592653589793238462643383279502884;
+        const double angle = -2.0 * Pi * numerator / denominator;
+
+        return std::complex<T>(T(std::cos(angle)), T(std::sin(angle)));
+    }
+
+    static inline bool isPowerOfTwo(const size_t size)
+    {
+        return (size > 0) && (0 == (size & (size-1)));
+    }
+
+    static inline size_t nextPowerOfTwo(const size_t size)
+    {
+        size_t ret = 1;
+        while(ret < size) ret <<= 1;
+
+        return ret;
+    }
+}
+
+// Plans are cached per size for as long as any block uses them.
+template <typename Plan>
+std::shared_ptr<const Plan> getCachedPlan(const size_t size)
+{
+    static std::mutex mutex;
+    static std::unordered_map<size_t, std::weak_ptr<const Plan>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto plan = cache[size].lock();
+        if(plan) return plan;
+    }
+
+    // Constructing a plan may require other cached plans, so don't hold the
+    // lock. If another thread makes the same plan in the meantime, use theirs.
+    std::shared_ptr<const Plan> newPlan(new Plan(size));
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto plan = cache[size].lock();
+    if(plan) return plan;
+
+    cache[size] = newPlan;
+    return newPlan;
+}
+
+//
+// Complex-to-complex transform
+//
+
+template <typename T>
+class FFTPlan
+{
+    public:
+        using Complex = std::complex<T>;
+
+        explicit FFTPlan(const size_t size):
+            _size(size)
+        {
+            if(0 == size) throw Pothos::InvalidArgumentException("FFT size must be positive.");
+
+            if(detail::isPowerOfTwo(size)) this->initRadix2();
+            else                           this->initBluestein();
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        // Number of complex elements the caller must provide to execute()
+        size_t workspaceSize() const
+        {
+            return _subPlan ? (_subPlan->size() + _subPlan->workspaceSize()) : 0;
+        }
+
+        // In place and unscaled, like NumPy's transforms before normalization.
+        void execute(
+            Complex* data,
+            const bool inverse,
+            Complex* workspace) const
+        {
+            if(_subPlan) this->executeBluestein(data, inverse, workspace);
+            else         this->executeRadix2(data, inverse);
+        }
+
+    private:
+        size_t _size;
+
+        // Radix-2
+        std::vector<std::pair<size_t, size_t>> _swaps;
+        std::vector<Complex> _twiddles;
+
+        // Bluestein
+        std::shared_ptr<const FFTPlan> _subPlan;
+        std::vector<Complex> _chirp;
+        std::vector<Complex> _chirpFilter;
+
+        void initRadix2()
+        {
+            size_t numBits = 0;
+            while((size_t(1) << numBits) < _size) ++numBits;
+
+            for(size_t i = 0; i < _size; ++i)
+            {
+                size_t reversed = 0;
+                for(size_t bit = 0; bit < numBits; ++bit)
+                {
+                    if(i & (size_t(1) << bit)) reversed |= (size_t(1) << (numBits-1-bit));
+                }
+
+                if(i < reversed) _swaps.emplace_back(i, reversed);
+            }
+
+            _twiddles.resize(_size / 2);
+            for(size_t k = 0; k < _twiddles.size(); ++k)
+            {
+                _twiddles[k] = detail::unitPhasor<T>(double(k), double(_size));
+            }
+        }
+
+        void executeRadix2(
+            Complex* data,
+            const bool inverse) const
+        {
+            for(const auto& swap: _swaps) std::swap(data[swap.first], data[swap.second]);
+
+            for(size_t len = 2; len <= _size; len <<= 1)
+            {
+                const size_t half = len / 2;
+                const size_t step = _size / len;
+
+                for(size_t start = 0; start < _size; start += len)
+                {
+                    for(size_t k = 0; k < half; ++k)
+                    {
+                        const Complex twiddle = inverse ? std::conj(_twiddles[k*step]) : _twiddles[k*step];
+
+                        const Complex even = data[start+k];
+                        const Complex odd = detail::complexMultiply(data[start+k+half], twiddle);
+
+                        data[start+k] = even + odd;
+                        data[start+k+half] = even - odd;
+                    }
+                }
+            }
+        }
+
+        void initBluestein()
+        {
+            const size_t subSize = detail::nextPowerOfTwo((2*_size) - 1);
+            _subPlan = getCachedPlan<FFTPlan>(subSize);
+
+            // chirp[k] = exp(-i*pi*k^2/n). Reducing k^2 mod 2n keeps the
+            // phase accurate for large k.
+            _chirp.resize(_size);
+            for(size_t k = 0; k < _size; ++k)
+            {
+                _chirp[k] = detail::unitPhasor<T>(double((k*k) % (2*_size)), double(2*_size));
+            }
+
+            // The convolution filter is the conjugate chirp, wrapped around
+            // for negative indices. It's stored pre-transformed and scaled
+            // by the inverse transform's normalization.
+            _chirpFilter.assign(subSize, Complex(0));
+            _chirpFilter[0] = std::conj(_chirp[0]);
+            for(size_t k = 1; k < _size; ++k)
+            {
+                _chirpFilter[k] = _chirpFilter[subSize-k] = std::conj(_chirp[k]);
+            }
+
+            std::vector<Complex> subWorkspace(_subPlan->workspaceSize());
+            _subPlan->execute(_chirpFilter.data(), false, subWorkspace.data());
+
+            const T scale = T(1) / T(subSize);
+            for(auto& value: _chirpFilter) value *= scale;
+        }
+
+        // An inverse transform is the conjugate of the forward transform of
+        // the conjugated input.
+        void executeBluestein(
+            Complex* data,
+            const bool inverse,
+            Complex* workspace) const
+        {
+            const size_t subSize = _subPlan->size();
+            Complex* conv = workspace;
+            Complex* subWorkspace = workspace + subSize;
+
+            for(size_t k = 0; k < _size; ++k)
+            {
+                conv[k] = detail::complexMultiply(inverse ? std::conj(data[k]) : data[k], _chirp[k]);
+            }
+            std::fill(conv+_size, conv+subSize, Complex(0));
+
+            _subPlan->execute(conv, false, subWorkspace);
+            for(size_t k = 0; k < subSize; ++k) conv[k] = detail::complexMultiply(conv[k], _chirpFilter[k]);
+            _subPlan->execute(conv, true, subWorkspace);
+
+            for(size_t k = 0; k < _size; ++k)
+            {
+                const Complex value = detail::complexMultiply(conv[k], _chirp[k]);
+                data[k] = inverse ? std::conj(value) : value;
+            }
+        }
+};
+
+//
+// Real-to-complex and complex-to-real transforms. Even sizes are computed with
+// a complex transform of half the size by packing even and odd samples into
+// the real and imaginary components, which halves the cost of the real-input
+// transforms spectrum monitoring relies on.
+//
+
+template <typename T>
+class RealFFTPlan
+{
+    public:
+        using Complex = std::complex<T>;
+
+        explicit RealFFTPlan(const size_t size):
+            _size(size)
+        {
+            if(0 == size) throw Pothos::InvalidArgumentException("FFT size must be positive.");
+
+            if(0 == (size % 2))
+            {
+                _plan = getCachedPlan<FFTPlan<T>>(size / 2);
+
+                _twiddles.resize((size / 2) + 1);
+                for(size_t k = 0; k < _twiddles.size(); ++k)
+                {
+                    _twiddles[k] = detail::unitPhasor<T>(double(k), double(size));
+                }
+            }
+            else _plan = getCachedPlan<FFTPlan<T>>(size);
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        // Number of output elements of forward(), or input elements of inverse()
+        size_t spectrumSize() const
+        {
+            return (_size / 2) + 1;
+        }
+
+        size_t workspaceSize() const
+        {
+            return _plan->size() + _plan->workspaceSize();
+        }
+
+        // _size real inputs to spectrumSize() complex outputs, multiplied by scale
+        void forward(
+            const T* in,
+            Complex* out,
+            const T scale,
+            Complex* workspace) const
+        {
+            const size_t planSize = _plan->size();
+            Complex* z = workspace;
+
+            if(_twiddles.empty())
+            {
+                for(size_t k = 0; k < _size; ++k) z[k] = Complex(in[k], T(0));
+                _plan->execute(z, false, workspace + planSize);
+
+                for(size_t k = 0; k < this->spectrumSize(); ++k) out[k] = z[k] * scale;
+                return;
+            }
+
+            for(size_t k = 0; k < planSize; ++k) z[k] = Complex(in[2*k], in[(2*k)+1]);
+            _plan->execute(z, false, workspace + planSize);
+
+            // Split the packed transform into the transforms of the even and
+            // odd samples, then combine them.
+            const Complex halfI(T(0), T(-0.5));
+            for(size_t k = 0; k <= planSize; ++k)
+            {
+                const Complex zk = z[k % planSize];
+                const Complex zmk = std::conj(z[(planSize - k) % planSize]);
+
+                const Complex even = (zk + zmk) * T(0.5);
+                const Complex odd = detail::complexMultiply(zk - zmk, halfI);
+
+                out[k] = (even + detail::complexMultiply(odd, _twiddles[k])) * scale;
+            }
+        }
+
+        // spectrumSize() complex inputs to _size real outputs, multiplied by
+        // scale. As in NumPy, the imaginary components of the DC and (for
+        // even sizes) Nyquist terms are ignored.
+        void inverse(
+            const Complex* in,
+            T* out,
+            const T scale,
+            Complex* workspace) const
+        {
+            const size_t planSize = _plan->size();
+            const size_t spectrumSize = this->spectrumSize();
+            Complex* z = workspace;
+
+            const auto getInput = [&](const size_t k) -> Complex
+            {
+                if((0 == k) || ((0 == (_size % 2)) && ((spectrumSize-1) == k))) return Complex(in[k].real(), T(0));
+                else return in[k];
+            };
+
+            if(_twiddles.empty())
+            {
+                // Rebuild the negative frequencies from Hermitian symmetry.
+                for(size_t k = 0; k < spectrumSize; ++k) z[k] = getInput(k);
+                for(size_t k = spectrumSize; k < _size; ++k) z[k] = std::conj(getInput(_size - k));
+
+                _plan->execute(z, true, workspace + planSize);
+
+                for(size_t k = 0; k < _size; ++k) out[k] = z[k].real() * scale;
+                return;
+            }
+
+            // Undo the split in forward(), giving the packed transform of the
+            // even and odd samples.
+            const Complex i(T(0), T(1));
+            for(size_t k = 0; k < planSize; ++k)
+            {
+                const Complex xk = getInput(k);
+                const Complex xmk = std::conj(getInput(planSize - k));
+
+                const Complex even = (xk + xmk) * T(0.5);
+                const Complex odd = detail::complexMultiply((xk - xmk) * T(0.5), std::conj(_twiddles[k]));
+
+                z[k] = even + detail::complexMultiply(odd, i);
+            }
+
+            _plan->execute(z, true, workspace + planSize);
+
+            // The half-size inverse transform is normalized by planSize,
+            // which is half of the full transform's size.
+            const T packedScale = scale * T(2);
+            for(size_t k = 0; k < planSize; ++k)
+            {
+                out[2*k] = z[k].real() * packedScale;
+                out[(2*k)+1] = z[k].imag() * packedScale;
+            }
+        }
+
+    private:
+        size_t _size;
+        std::shared_ptr<const FFTPlan<T>> _plan;
+        std::vector<Complex> _twiddles;
+};
+
+}
@@ -0,0 +1,549 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/FFT.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <Poco/Logger.h>
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+template <typename T>
+struct ScalarType
+{
+    using type = T;
+};
+
+template <typename T>
+struct ScalarType<std::complex<T>>
+{
+    using type = T;
+};
+
+//
+// Transforms, each matching the numpy.fft function its block is named after.
+// numBins is the number of input elements per frame, and each transform
+// writes its output frame directly into the output buffer.
+//
+
+// fft, ifft
+template <typename InT, bool Inverse>
+class ComplexTransform
+{
+    public:
+        using InType = InT;
+        using Scalar = typename ScalarType<InType>::type;
+        using OutType = std::complex<Scalar>;
+
+        ComplexTransform(const size_t numBins):
+            _plan(PothosNumPy::getCachedPlan<PothosNumPy::FFTPlan<Scalar>>(numBins)),
+            _workspace(_plan->workspaceSize())
+        {}
+
+        size_t inputFrameSize() const
+        {
+            return _plan->size();
+        }
+
+        size_t outputFrameSize() const
+        {
+            return _plan->size();
+        }
+
+        void execute(const InType* in, OutType* out)
+        {
+            const size_t size = _plan->size();
+
+            std::copy(in, in+size, out);
+            _plan->execute(out, Inverse, _workspace.data());
+
+            if(Inverse)
+            {
+                const Scalar scale = Scalar(1) / Scalar(size);
+                for(size_t elem = 0; elem < size; ++elem) out[elem] *= scale;
+            }
+        }
+
+    private:
+        std::shared_ptr<const PothosNumPy::FFTPlan<Scalar>> _plan;
+        std::vector<OutType> _workspace;
+};
+
+// rfft, ihfft
+template <typename T, bool Hermitian>
+class RealForwardTransform
+{
+    public:
+        using InType = T;
+        using OutType = std::complex<T>;
+
+        RealForwardTransform(const size_t numBins):
+            _plan(PothosNumPy::getCachedPlan<PothosNumPy::RealFFTPlan<T>>(numBins)),
+            _workspace(_plan->workspaceSize())
+        {}
+
+        size_t inputFrameSize() const
+        {
+            return _plan->size();
+        }
+
+        size_t outputFrameSize() const
+        {
+            return _plan->spectrumSize();
+        }
+
+        // ihfft(a) == conj(rfft(a))/n
+        void execute(const InType* in, OutType* out)
+        {
+            const T scale = Hermitian ? (T(1) / T(_plan->size())) : T(1);
+            _plan->forward(in, out, scale, _workspace.data());
+
+            if(Hermitian)
+            {
+                for(size_t elem = 0; elem < _plan->spectrumSize(); ++elem) out[elem] = std::conj(out[elem]);
+            }
+        }
+
+    private:
+        std::shared_ptr<const PothosNumPy::RealFFTPlan<T>> _plan;
+        std::vector<OutType> _workspace;
+};
+
+// irfft, hfft
+template <typename InT, bool Hermitian>
+class RealInverseTransform
+{
+    public:
+        using InType = InT;
+        using OutType = typename ScalarType<InType>::type;
+        using Complex = std::complex<OutType>;
+
+        RealInverseTransform(const size_t numBins):
+            _plan(PothosNumPy::getCachedPlan<PothosNumPy::RealFFTPlan<OutType>>(getOutputSize(numBins))),
+            _input(numBins),
+            _workspace(_plan->workspaceSize())
+        {}
+
+        size_t inputFrameSize() const
+        {
+            return _input.size();
+        }
+
+        size_t outputFrameSize() const
+        {
+            return _plan->size();
+        }
+
+        // hfft(a) == irfft(conj(a))*n
+        void execute(const InType* in, OutType* out)
+        {
+            for(size_t elem = 0; elem < _input.size(); ++elem)
+            {
+                _input[elem] = Hermitian ? std::conj(Complex(in[elem])) : Complex(in[elem]);
+            }
+
+            const OutType scale = Hermitian ? OutType(1) : (OutType(1) / OutType(_plan->size()));
+            _plan->inverse(_input.data(), out, scale, _workspace.data());
+        }
+
+    private:
+        std::shared_ptr<const PothosNumPy::RealFFTPlan<OutType>> _plan;
+        std::vector<Complex> _input;
+        std::vector<Complex> _workspace;
+
+        // Like NumPy, output 2*(m-1) points for m inputs.
+        static size_t getOutputSize(const size_t numBins)
+        {
+            if(numBins < 2)
+            {
+                throw Pothos::InvalidArgumentException("numBins must be at least 2.");
+            }
+
+            return 2*(numBins-1);
+        }
+};
+
+//
+// Block
+//
+
+template <typename Transform>
+class FFTBlock: public PothosNumPy::BaseBlock
+{
+    public:
+        using InType = typename Transform::InType;
+        using OutType = typename Transform::OutType;
+
+        FFTBlock(const std::string& blockPath, const size_t numBins):
+            PothosNumPy::BaseBlock(blockPath),
+            _transform(numBins),
+            _numBins(numBins)
+        {
+            this->registerCall(this, POTHOS_FCN_TUPLE(FFTBlock, numBins));
+            this->registerProbe("numBins");
+
+            this->setupInput(0, Pothos::DType(typeid(InType)));
+            this->setupOutput(0, Pothos::DType(typeid(OutType)));
+
+            // Only called with at least a full frame of input and room for
+            // a full frame of output.
+            this->input(0)->setReserve(_transform.inputFrameSize());
+            this->output(0)->setReserve(_transform.outputFrameSize());
+        }
+
+        virtual ~FFTBlock() = default;
+
+        size_t numBins() const
+        {
+            return _numBins;
+        }
+
+        void work() override
+        {
+            const size_t inputFrameSize = _transform.inputFrameSize();
+            const size_t outputFrameSize = _transform.outputFrameSize();
+
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            // Transform every complete frame available in a single call,
+            // so per-call overhead is amortized across frames when numBins
+            // is small.
+            const size_t numFrames = std::min(
+                input->elements() / inputFrameSize,
+                output->elements() / outputFrameSize);
+            if(!this->countWork(numFrames * inputFrameSize)) return;
+
+            const InType* in = input->buffer();
+            OutType* out = output->buffer();
+
+            this->timeFunc([&]()
+            {
+                for(size_t frame = 0; frame < numFrames; ++frame)
+                {
+                    _transform.execute(in + (frame * inputFrameSize), out + (frame * outputFrameSize));
+                }
+            });
+
+            input->consume(numFrames * inputFrameSize);
+            output->produce(numFrames * outputFrameSize);
+            this->countElements(numFrames * inputFrameSize, numFrames * outputFrameSize);
+        }
+
+    private:
+        Transform _transform;
+        size_t _numBins;
+};
+
+//
+// Factories
+//
+
+#define ifTypeDeclareFactory(T, ...) \
+    if(Pothos::DType::fromDType(dtype, 1) == Pothos::DType(typeid(T))) \
+        return new FFTBlock<__VA_ARGS__>(blockPath, numBins);
+
+/***********************************************************************
+ * |PothosDoc FFT (NumPy)
+ *
+ * Compute the one-dimensional discrete Fourier Transform.
+ *
+ * This function computes the one-dimensional n-point discrete Fourier
+ * Transform (DFT) with the efficient Fast Fourier Transform (FFT) algorithm [CT].
+ *
+ * FFT (Fast Fourier Transform) refers to a way the discrete Fourier Transfor
+ * (DFT) can be calculated efficiently, by using symmetries in the calculated
+ * terms. The symmetry is highest when n is a power of 2, and the transform is
+ * therefore most efficient for these sizes.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.fft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft discrete fast fourier transform
+ * |factory /numpy/fft/fft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/fft";
+
+    // Non-powers of 2 use Bluestein's algorithm, which is several times slower.
+    if(!PothosNumPy::detail::isPowerOfTwo(numBins))
+    {
+        poco_warning(
+            Poco::Logger::get(blockPath),
+            "numBins was specified as "+std::to_string(numBins)+", which is not a power of 2. "
+            "This will result in suboptimal performance.");
+    }
+
+    ifTypeDeclareFactory(float, ComplexTransform<float, false>)
+    ifTypeDeclareFactory(double, ComplexTransform<double, false>)
+    ifTypeDeclareFactory(std::complex<float>, ComplexTransform<std::complex<float>, false>)
+    ifTypeDeclareFactory(std::complex<double>, ComplexTransform<std::complex<double>, false>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+/***********************************************************************
+ * |PothosDoc Inverse FFT (NumPy)
+ *
+ * Compute the one-dimensional inverse discrete Fourier Transform.
+ *
+ * This function computes the inverse of the one-dimensional n-point discrete
+ * Fourier transform computed by <b>/numpy/fft/fft</b>. In other words,
+ * <b>ifft(fft(a)) == a</b> to within numerical accuracy.
+ *
+ * The input should be ordered in the same way as is returned by fft, i.e.,
+ * <ul>
+ * <li><b>a[0]</b> should contain the zero frequency term,</li>
+ * <li><b>a[1:n//2]</b> should contain the positive-frequency terms,</li>
+ * <li><b>a[n//2 + 1:]</b> should contain the negative-frequency terms, in
+ *     increasing order starting from the most negative frequency.</li>
+ * </ul>
+ *
+ * For an even number of input points, <b>A[n//2]</b> represents the sum of the
+ * values at the positive and negative Nyquist frequencies, as the two are
+ * aliased together.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.ifft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft ifft inverse discrete fast fourier transform
+ * |factory /numpy/fft/ifft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeIFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/ifft";
+
+    ifTypeDeclareFactory(float, ComplexTransform<float, true>)
+    ifTypeDeclareFactory(double, ComplexTransform<double, true>)
+    ifTypeDeclareFactory(std::complex<float>, ComplexTransform<std::complex<float>, true>)
+    ifTypeDeclareFactory(std::complex<double>, ComplexTransform<std::complex<double>, true>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+/***********************************************************************
+ * |PothosDoc Real FFT (NumPy)
+ *
+ * Compute the one-dimensional discrete Fourier Transform for real input.
+ *
+ * This function computes the one-dimensional n-point discrete Fourier
+ * Transform (DFT) of a real-valued array by means of an efficient algorithm
+ * called the Fast Fourier Transform (FFT).
+ *
+ * When the DFT is computed for purely real input, the output is
+ * Hermitian-symmetric, i.e. the negative frequency terms are just the complex
+ * conjugates of the corresponding positive-frequency terms, and the
+ * negative-frequency terms are therefore redundant. This function does not
+ * compute the negative frequency terms, and the length of the transformed
+ * axis of the output is therefore n//2 + 1.
+ *
+ * When <b>A = rfft(a)</b> and <b>fs</b> is the sampling frequency, <b>A[0]</b>
+ * contains the zero-frequency term <b>0*fs</b>, which is real due to Hermitian
+ * symmetry.
+ *
+ * If <b>n</b> is even, <b>A[-1]</b> contains the term representing both
+ * positive and negative Nyquist frequency <b>(+fs/2 and -fs/2)</b>, and must
+ * also be purely real. If <b>n</b> is odd, there is no term at <b>fs/2</b>;
+ * <b>A[-1]</b> contains the largest positive frequency <b>(fs/2*(n-1)/n)</b>,
+ * and is complex in the general case.
+ *
+ * If the input a contains an imaginary part, it is silently discarded.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.rfft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft rfft real discrete fast fourier transform
+ * |factory /numpy/fft/rfft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeRFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/rfft";
+
+    ifTypeDeclareFactory(float, RealForwardTransform<float, false>)
+    ifTypeDeclareFactory(double, RealForwardTransform<double, false>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+/***********************************************************************
+ * |PothosDoc Inverse Real FFT (NumPy)
+ *
+ * Compute the inverse of the n-point DFT for real input.
+ *
+ * This function computes the inverse of the one-dimensional n-point discrete
+ * Fourier Transform of real input computed by <b>/numpy/fft/rfft</b>. In other
+ * words, <b>irfft(rfft(a), len(a)) == a</b> to within numerical accuracy.
+ *
+ * The input is expected to be in the form returned by rfft, i.e. the real
+ * zero-frequency term followed by the complex positive frequency terms in
+ * order of increasing frequency. Since the discrete Fourier Transform of
+ * real input is Hermitian-symmetric, the negative frequency terms are taken
+ * to be the complex conjugates of the corresponding positive frequency terms.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.rifft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft rfft rifft real inverse discrete fast fourier transform
+ * |factory /numpy/fft/irfft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeIRFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/irfft";
+
+    ifTypeDeclareFactory(float, RealInverseTransform<float, false>)
+    ifTypeDeclareFactory(double, RealInverseTransform<double, false>)
+    ifTypeDeclareFactory(std::complex<float>, RealInverseTransform<std::complex<float>, false>)
+    ifTypeDeclareFactory(std::complex<double>, RealInverseTransform<std::complex<double>, false>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+/***********************************************************************
+ * |PothosDoc Hermetian FFT (NumPy)
+ *
+ * Compute the FFT of a signal that has Hermitian symmetry, i.e., a real
+ * spectrum. Here the signal has Hermitian symmetry in the time domain and
+ * is real in the frequency domain.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.hfft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft hfft hermetian discrete fast fourier transform
+ * |factory /numpy/fft/hfft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeHFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/hfft";
+
+    ifTypeDeclareFactory(float, RealInverseTransform<float, true>)
+    ifTypeDeclareFactory(double, RealInverseTransform<double, true>)
+    ifTypeDeclareFactory(std::complex<float>, RealInverseTransform<std::complex<float>, true>)
+    ifTypeDeclareFactory(std::complex<double>, RealInverseTransform<std::complex<double>, true>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+/***********************************************************************
+ * |PothosDoc Inverse Hermetian FFT (NumPy)
+ *
+ * Compute the inverse FFT of a signal that has Hermitian symmetry, i.e., a
+ * real spectrum. Here the signal has Hermitian symmetry in the time domain and
+ * is real in the frequency domain.
+ *
+ * Corresponding NumPy function: <b>numpy.fft.hfft</b>
+ *
+ * |category /NumPy/FFT
+ * |category /FFT/NumPy
+ * |keywords fft hfft ihfft inverse hermetian discrete fast fourier transform
+ * |factory /numpy/fft/ihfft(dtype,numBins)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins]
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ **********************************************************************/
+static Pothos::Block* makeIHFFT(const Pothos::DType& dtype, const size_t numBins)
+{
+    static const std::string blockPath = "/numpy/fft/ihfft";
+
+    ifTypeDeclareFactory(float, RealForwardTransform<float, true>)
+    ifTypeDeclareFactory(double, RealForwardTransform<double, true>)
+
+    throw Pothos::InvalidArgumentException("Unsupported type", dtype.name());
+}
+
+static const std::vector<Pothos::BlockRegistry> fftBlockRegistries =
+{
+    Pothos::BlockRegistry("/numpy/fft/fft", Pothos::Callable(&makeFFT)),
+    Pothos::BlockRegistry("/numpy/fft/ifft", Pothos::Callable(&makeIFFT)),
+    Pothos::BlockRegistry("/numpy/fft/rfft", Pothos::Callable(&makeRFFT)),
+    Pothos::BlockRegistry("/numpy/fft/irfft", Pothos::Callable(&makeIRFFT)),
+    Pothos::BlockRegistry("/numpy/fft/hfft", Pothos::Callable(&makeHFFT)),
+    Pothos::BlockRegistry("/numpy/fft/ihfft", Pothos::Callable(&makeIHFFT)),
+};
@@ -0,0 +1,234 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/AsyncFileWriter.hpp"
+#include "Cpp/BaseBlock.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/Timestamp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace PothosNumPy
+{
+
+//
+// Some sinks write a series of files, such as segments or triggered
+// captures. Each is named after the block's filepath, with either a sequence
+// number or the UTC time it was started.
+//
+
+static inline void checkSeriesNaming(const std::string& naming)
+{
+    if(("numbered" != naming) && ("timestamp" != naming))
+    {
+        throw Pothos::InvalidArgumentException("Invalid file naming", naming);
+    }
+}
+
+// For example, capture.npy becomes capture_000000.npy or
+// capture_20230102T030405.678901Z.npy.
+static inline std::string makeSeriesFilepath(
+    const std::string& filepath,
+    const std::string& naming,
+    const size_t index)
+{
+    std::string suffix;
+    if("timestamp" == naming)
+    {
+        suffix = Poco::DateTimeFormatter::format(Poco::Timestamp(), "%Y%m%dT%H%M%S.%FZ");
+    }
+    else
+    {
+        suffix = std::to_string(index);
+        if(suffix.size() < 6) suffix.insert(0, 6 - suffix.size(), '0');
+    }
+
+    Poco::Path seriesPath(filepath);
+    seriesPath.setBaseName(seriesPath.getBaseName() + "_" + suffix);
+
+    return seriesPath.toString();
+}
+
+// Each file in a series is written with a ".part" suffix, then closed and
+// renamed on a background thread, so anything without the suffix is
+// complete. The result is the final path, or any error from finishing it.
+static inline std::future<std::string> finishPartFile(
+    std::unique_ptr<AsyncFileWriter>&& file,
+    const std::string& filepath)
+{
+    std::shared_ptr<AsyncFileWriter> sharedFile(file.release());
+    return std::async(std::launch::async, [sharedFile, filepath]()
+    {
+        sharedFile->close();
+        Poco::File(filepath + ".part").renameTo(filepath);
+
+        return filepath;
+    });
+}
+
+//
+// Common to the native file sinks, which write through an AsyncFileWriter.
+// The sync settings take effect the next time the block is activated. The
+// probes describe the current or most recent activation.
+//
+
+class FileSinkBlock: public BaseBlock
+{
+    public:
+        FileSinkBlock(const std::string& blockPath):
+            BaseBlock(blockPath),
+            _syncMode(FileSyncMode::OnClose),
+            _syncIntervalMB(64.0),
+            _numSeriesFiles(0)
+        {
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, syncMode));
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, setSyncMode));
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, syncIntervalMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, setSyncIntervalMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, writeQueueDepth));
+            this->registerCall(this, POTHOS_FCN_TUPLE(FileSinkBlock, writeBlockedSeconds));
+
+            this->registerProbe("writeQueueDepth");
+            this->registerProbe("writeBlockedSeconds");
+        }
+
+        virtual ~FileSinkBlock() = default;
+
+        std::string syncMode() const
+        {
+            switch(_syncMode)
+            {
+            case FileSyncMode::Never:
+                return "never";
+
+            case FileSyncMode::Interval:
+                return "interval";
+
+            default:
+                return "close";
+            }
+        }
+
+        void setSyncMode(const std::string& syncMode)
+        {
+            if("never" == syncMode)         _syncMode = FileSyncMode::Never;
+            else if("close" == syncMode)    _syncMode = FileSyncMode::OnClose;
+            else if("interval" == syncMode) _syncMode = FileSyncMode::Interval;
+            else throw Pothos::InvalidArgumentException("Invalid sync mode", syncMode);
+        }
+
+        double syncIntervalMB() const
+        {
+            return _syncIntervalMB;
+        }
+
+        void setSyncIntervalMB(const double syncIntervalMB)
+        {
+            if(syncIntervalMB <= 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Sync interval must be positive.");
+            }
+
+            _syncIntervalMB = syncIntervalMB;
+        }
+
+        // The number of buffers waiting to be written to disk
+        size_t writeQueueDepth() const
+        {
+            const auto* writer = this->fileWriter();
+            return writer ? writer->queueDepth() : 0;
+        }
+
+        // Time work() spent waiting on the disk because every buffer was full
+        double writeBlockedSeconds() const
+        {
+            const auto* writer = this->fileWriter();
+            return writer ? writer->blockedSeconds() : 0.0;
+        }
+
+    protected:
+        // The writer for the current or most recent activation, if any
+        virtual const AsyncFileWriter* fileWriter() const = 0;
+
+        FileSyncMode fileSyncMode() const
+        {
+            return _syncMode;
+        }
+
+        std::uint64_t fileSyncInterval() const
+        {
+            return std::max<std::uint64_t>(std::uint64_t(_syncIntervalMB * (1 << 20)), 1);
+        }
+
+        // For sinks that write a series of files. Each file is finished in
+        // the background, and the given signal emits its path once it is.
+        void setupSeriesSignal(const std::string& name)
+        {
+            this->registerSignal(name);
+            _seriesSignal = name;
+        }
+
+        // Waits for the previous file to be finished first.
+        void finishSeriesFile(
+            std::unique_ptr<AsyncFileWriter>&& file,
+            const std::string& filepath)
+        {
+            this->waitForSeriesFile();
+            _finishingSeriesFile = finishPartFile(std::move(file), filepath);
+        }
+
+        // Rethrows any error from finishing the file. If block is false,
+        // this returns right away if the file isn't finished yet.
+        void waitForSeriesFile(const bool block = true)
+        {
+            if(!_finishingSeriesFile.valid()) return;
+            if(!block && (std::future_status::ready != _finishingSeriesFile.wait_for(std::chrono::seconds(0)))) return;
+
+            _lastSeriesFilePath = _finishingSeriesFile.get();
+            ++_numSeriesFiles;
+            this->emitSignal(_seriesSignal, _lastSeriesFilePath);
+        }
+
+        void resetSeries()
+        {
+            _numSeriesFiles = 0;
+            _lastSeriesFilePath.clear();
+        }
+
+        // Files finished since the last reset
+        size_t numSeriesFiles() const
+        {
+            return _numSeriesFiles;
+        }
+
+        std::string lastSeriesFilePath() const
+        {
+            return _lastSeriesFilePath;
+        }
+
+    private:
+        FileSyncMode _syncMode;
+        double _syncIntervalMB;
+
+        std::string _seriesSignal;
+
+        // Resolves to the file's path once it's renamed
+        std::future<std::string> _finishingSeriesFile;
+        size_t _numSeriesFiles;
+        std::string _lastSeriesFilePath;
+};
+
+}
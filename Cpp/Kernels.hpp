@@ -0,0 +1,130 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/ElementwiseFunctions.hpp"
+#include "Cpp/Utility.hpp"
+
+#include <complex>
+#include <cstddef>
+
+//
+// Loops used by the native blocks to apply the functors in
+// ElementwiseFunctions.hpp over a whole buffer. Pothos input and output
+// buffers never overlap, so marking the pointers as non-aliasing lets the
+// compiler vectorize these loops for whatever instruction set it targets.
+//
+
+#if defined(_MSC_VER)
+#define POTHOS_NUMPY_RESTRICT __restrict
+#else
+#define POTHOS_NUMPY_RESTRICT __restrict__
+#endif
+
+namespace PothosNumPy
+{
+
+template <typename Func>
+struct UnaryKernel
+{
+    using InType = typename Func::InType;
+    using OutType = typename Func::OutType;
+
+    static void run(
+        const InType* POTHOS_NUMPY_RESTRICT in,
+        OutType* POTHOS_NUMPY_RESTRICT out,
+        size_t numElems)
+    {
+        for(size_t elem = 0; elem < numElems; ++elem)
+        {
+            out[elem] = Func::apply(in[elem]);
+        }
+    }
+};
+
+template <typename Func>
+struct BinaryKernel
+{
+    using InType = typename Func::InType;
+    using OutType = typename Func::OutType;
+
+    static void run(
+        const InType* POTHOS_NUMPY_RESTRICT in0,
+        const InType* POTHOS_NUMPY_RESTRICT in1,
+        OutType* POTHOS_NUMPY_RESTRICT out,
+        size_t numElems)
+    {
+        for(size_t elem = 0; elem < numElems; ++elem)
+        {
+            out[elem] = Func::apply(in0[elem], in1[elem]);
+        }
+    }
+
+    // out = func(out, in), for reducing multiple inputs into one output
+    static void accumulate(
+        const InType* POTHOS_NUMPY_RESTRICT in,
+        OutType* POTHOS_NUMPY_RESTRICT out,
+        size_t numElems)
+    {
+        for(size_t elem = 0; elem < numElems; ++elem)
+        {
+            out[elem] = Func::apply(out[elem], in[elem]);
+        }
+    }
+};
+
+//
+// std::complex's operator* has to account for infinities and NaNs, so
+// compilers emit a library call per element instead of vectorizing. NumPy
+// uses the textbook formula, so operate on the interleaved real and
+// imaginary components directly.
+//
+
+template <typename T>
+struct BinaryKernel<Multiply<std::complex<T>>>
+{
+    using InType = std::complex<T>;
+    using OutType = std::complex<T>;
+
+    static void run(
+        const InType* POTHOS_NUMPY_RESTRICT in0,
+        const InType* POTHOS_NUMPY_RESTRICT in1,
+        OutType* POTHOS_NUMPY_RESTRICT out,
+        size_t numElems)
+    {
+        // std::complex<T> is guaranteed to be layout-compatible with T[2].
+        const T* POTHOS_NUMPY_RESTRICT x = reinterpret_cast<const T*>(in0);
+        const T* POTHOS_NUMPY_RESTRICT y = reinterpret_cast<const T*>(in1);
+        T* POTHOS_NUMPY_RESTRICT z = reinterpret_cast<T*>(out);
+
+        for(size_t elem = 0; elem < (numElems*2); elem += 2)
+        {
+            const T xr = x[elem], xi = x[elem+1];
+            const T yr = y[elem], yi = y[elem+1];
+
+            z[elem]   = (xr*yr) - (xi*yi);
+            z[elem+1] = (xr*yi) + (xi*yr);
+        }
+    }
+
+    static void accumulate(
+        const InType* POTHOS_NUMPY_RESTRICT in,
+        OutType* POTHOS_NUMPY_RESTRICT out,
+        size_t numElems)
+    {
+        const T* POTHOS_NUMPY_RESTRICT y = reinterpret_cast<const T*>(in);
+        T* POTHOS_NUMPY_RESTRICT z = reinterpret_cast<T*>(out);
+
+        for(size_t elem = 0; elem < (numElems*2); elem += 2)
+        {
+            const T xr = z[elem], xi = z[elem+1];
+            const T yr = y[elem], yi = y[elem+1];
+
+            z[elem]   = (xr*yr) - (xi*yi);
+            z[elem+1] = (xr*yi) + (xi*yr);
+        }
+    }
+};
+
+}
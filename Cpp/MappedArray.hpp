@@ -0,0 +1,285 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/MappedReadAhead.hpp"
+#include "Cpp/NpyFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <Poco/SharedMemory.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// An array in a memory-mapped file, played as one or more channels. Buffers
+// posted straight from the mapping hold a reference to it, so the file stays
+// mapped until downstream blocks are done with them.
+//
+// Byteswapped data, interleaved channels, and data that isn't aligned to its
+// type can't be used as-is, so they must be copied into the output buffers
+// instead.
+//
+
+class MappedArray
+{
+    public:
+        MappedArray():
+            _dataOffset(0),
+            _numChannels(0),
+            _numElements(0),
+            _swapSize(0),
+            _isInterleaved(false),
+            _isAligned(true)
+        {}
+
+        // Maps the array, which starts dataOffset bytes into the file.
+        // Non-interleaved channels are stored one after another. The caller
+        // is responsible for checking that the file is large enough.
+        MappedArray(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const std::uint64_t dataOffset,
+            const size_t numChannels,
+            const size_t numElements,
+            const bool byteSwapped,
+            const bool isInterleaved
+        ):
+            _filepath(filepath),
+            _dataOffset(dataOffset),
+            _dtype(dtype),
+            _numChannels(numChannels),
+            _numElements(numElements),
+            _swapSize(0),
+            _isInterleaved(isInterleaved && (numChannels > 1)),
+            _isAligned(true)
+        {
+            const auto wordSize = getByteSwapWordSize(dtype);
+            if(byteSwapped && (wordSize > 1)) _swapSize = wordSize;
+
+            // Empty files can't be mapped.
+            const size_t dataSize = numChannels * numElements * dtype.elemSize();
+            if(dataSize > 0)
+            {
+                std::shared_ptr<Poco::SharedMemory> mapping(new Poco::SharedMemory(
+                    Poco::File(filepath),
+                    Poco::SharedMemory::AM_READ));
+
+                _data = Pothos::SharedBuffer(
+                    size_t(mapping->begin()) + size_t(dataOffset),
+                    dataSize,
+                    mapping);
+
+                // Raw files can start at any offset, which isn't always
+                // aligned to the type.
+                _isAligned = (0 == (_data.getAddress() % wordSize));
+            }
+        }
+
+        // A 1D array is played as a single channel, and each row of a 2D
+        // array as a channel. Fortran-order 2D arrays store the channels
+        // interleaved.
+        static MappedArray fromNpyFile(const std::string& filepath)
+        {
+            if(!Poco::File(filepath).exists())
+            {
+                throw Pothos::FileNotFoundException("The given file does not exist", filepath);
+            }
+            if(Poco::Path(filepath).getExtension() != "npy")
+            {
+                throw Pothos::InvalidArgumentException("This block only accepts .npy files.", filepath);
+            }
+
+            NpyHeader header;
+            {
+                std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+                if(!stream)
+                {
+                    throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+                }
+
+                header = readNpyHeader(stream, filepath);
+            }
+
+            if((1 != header.shape.size()) && (2 != header.shape.size()))
+            {
+                throw Pothos::DataFormatException("This block only supports 1D or 2D arrays.", filepath);
+            }
+
+            const auto dtype = npyDescrToDType(header.descr);
+            const size_t numChannels = (1 == header.shape.size()) ? 1 : header.shape[0];
+            const size_t numElements = header.shape.back();
+
+            const size_t dataSize = numChannels * numElements * dtype.elemSize();
+            if(Poco::File(filepath).getSize() < (header.dataOffset + dataSize))
+            {
+                throw Pothos::DataFormatException("File is smaller than its header indicates", filepath);
+            }
+
+            return MappedArray(
+                filepath,
+                dtype,
+                header.dataOffset,
+                numChannels,
+                numElements,
+                isNpyDescrByteSwapped(header.descr),
+                header.fortranOrder);
+        }
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        // Where the array starts in the file
+        std::uint64_t dataOffset() const
+        {
+            return _dataOffset;
+        }
+
+        const Pothos::DType& dtype() const
+        {
+            return _dtype;
+        }
+
+        size_t numChannels() const
+        {
+            return _numChannels;
+        }
+
+        // Per channel
+        size_t numElements() const
+        {
+            return _numElements;
+        }
+
+        // Whether each sample's channels are stored together
+        bool isInterleaved() const
+        {
+            return _isInterleaved;
+        }
+
+        const char* data() const
+        {
+            return reinterpret_cast<const char*>(_data.getAddress());
+        }
+
+        size_t size() const
+        {
+            return _data.getLength();
+        }
+
+        // Whether output buffers can point straight into the mapping
+        bool canPostInPlace() const
+        {
+            return (0 == _swapSize) && !_isInterleaved && _isAligned;
+        }
+
+        // Posts elems samples of each channel, starting at index pos.
+        void postChannels(
+            const std::vector<Pothos::OutputPort*>& outputs,
+            const size_t pos,
+            const size_t elems) const
+        {
+            const auto elemSize = _dtype.elemSize();
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                Pothos::BufferChunk chunk(_data);
+                chunk.dtype = _dtype;
+                chunk.address += ((chan * _numElements) + pos) * elemSize;
+                chunk.length = elems * elemSize;
+
+                outputs[chan]->postBuffer(std::move(chunk));
+            }
+        }
+
+        // Copies elems samples of each channel, starting at index pos, into
+        // the output buffers. The caller produces them.
+        void copyChannels(
+            const std::vector<Pothos::OutputPort*>& outputs,
+            const size_t pos,
+            const size_t elems) const
+        {
+            const auto elemSize = _dtype.elemSize();
+            const auto* src = this->data();
+
+            std::vector<char*> dsts;
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                dsts.emplace_back(outputs[chan]->buffer().as<char*>());
+            }
+
+            if(_isInterleaved)
+            {
+                deinterleaveChannels(src + (pos * _numChannels * elemSize), dsts, elems, elemSize);
+            }
+            else
+            {
+                for(size_t chan = 0; chan < _numChannels; ++chan)
+                {
+                    std::memcpy(dsts[chan], src + (((chan * _numElements) + pos) * elemSize), elems * elemSize);
+                }
+            }
+
+            if(_swapSize > 0)
+            {
+                for(auto* dst: dsts) byteswapWords(dst, elems * elemSize, _swapSize);
+            }
+        }
+
+        // Reads up to size bytes from the start of each channel into memory,
+        // so playback doesn't wait on page faults when it gets there.
+        // Interleaved channels are read together, so that's size bytes per
+        // channel from the start of the data.
+        void prefault(const size_t size) const
+        {
+            if(0 == this->size()) return;
+
+            const auto pageSize = detail::getPageSize();
+            const size_t numStreams = _isInterleaved ? 1 : _numChannels;
+            const size_t streamSize = this->size() / numStreams;
+            const size_t prefaultSize = std::min(streamSize, size * (_numChannels / numStreams));
+
+            for(size_t stream = 0; stream < numStreams; ++stream)
+            {
+                const auto* begin = this->data() + (stream * streamSize);
+                (void)detail::adviseMapped(begin, begin + prefaultSize, detail::MappedAdvice::WillNeed);
+
+                for(size_t pos = 0; pos < prefaultSize; pos += pageSize)
+                {
+                    (void)*reinterpret_cast<const volatile char*>(begin + pos);
+                }
+            }
+        }
+
+    private:
+        std::string _filepath;
+        std::uint64_t _dataOffset;
+
+        Pothos::DType _dtype;
+        Pothos::SharedBuffer _data;
+
+        size_t _numChannels;
+        size_t _numElements;
+
+        // Nonzero if each word of this many bytes must be byteswapped
+        size_t _swapSize;
+
+        bool _isInterleaved;
+        bool _isAligned;
+};
+
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/MappedArray.hpp"
+#include "Cpp/MappedReadAhead.hpp"
+#include "Cpp/WindowedSourceBlock.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// Common to the native sources that play an array straight out of a file,
+// such as a .npy file or a raw capture. Subclasses map the array and pass
+// it to setArray().
+//
+// The output buffers point directly into the mapping where possible, so
+// samples are never copied, and the file stays mapped until downstream
+// blocks are done with them, even after this block is destroyed.
+//
+// Since the whole file is mapped, moving the playback window or seeking
+// within it only changes the index the next buffer starts at.
+//
+// Otherwise, the mapping is paged in on demand, one fault at a time. With
+// read-ahead enabled, the pages ahead of each channel's read position are
+// requested before they're needed.
+//
+
+class MappedFileSource: public WindowedSourceBlock
+{
+    public:
+        MappedFileSource(
+            const std::string& blockPath,
+            const std::string& filepath,
+            const bool repeat
+        ):
+            WindowedSourceBlock(blockPath, repeat),
+            _filepath(filepath),
+            _readAheadMB(0.0),
+            _dropReadPages(false),
+            _prefetchThread(false),
+            _droppedBytes(0)
+        {
+            if(!Poco::File(filepath).exists())
+            {
+                throw Pothos::FileNotFoundException("The given file does not exist", filepath);
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, readAheadMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, setReadAheadMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, dropReadPages));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, setDropReadPages));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, prefetchThread));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, setPrefetchThread));
+            this->registerCall(this, POTHOS_FCN_TUPLE(MappedFileSource, droppedReadMB));
+            this->registerProbe("droppedReadMB");
+        }
+
+        virtual ~MappedFileSource() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        // The read-ahead settings take effect the next time the block is
+        // activated. 0 disables read-ahead.
+        double readAheadMB() const
+        {
+            return _readAheadMB;
+        }
+
+        void setReadAheadMB(const double readAheadMB)
+        {
+            if(readAheadMB < 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Read-ahead size cannot be negative.");
+            }
+
+            _readAheadMB = readAheadMB;
+        }
+
+        bool dropReadPages() const
+        {
+            return _dropReadPages;
+        }
+
+        void setDropReadPages(const bool dropReadPages)
+        {
+            _dropReadPages = dropReadPages;
+        }
+
+        bool prefetchThread() const
+        {
+            return _prefetchThread;
+        }
+
+        void setPrefetchThread(const bool prefetchThread)
+        {
+            _prefetchThread = prefetchThread;
+        }
+
+        // How much has been released from memory by dropReadPages since the
+        // block was last activated
+        double droppedReadMB() const
+        {
+            auto droppedBytes = _droppedBytes;
+            for(const auto& readAhead: _readAheads) droppedBytes += readAhead->droppedBytes();
+
+            return double(droppedBytes) / (1 << 20);
+        }
+
+        void activate() override
+        {
+            _droppedBytes = 0;
+            if((0.0 == _readAheadMB) || (0 == _array.size())) return;
+
+            // Each channel is read from its own part of the file unless the
+            // channels are interleaved.
+            const size_t numStreams = _array.isInterleaved() ? 1 : _array.numChannels();
+            const size_t streamSize = _array.size() / numStreams;
+            const auto* data = _array.data();
+
+            for(size_t stream = 0; stream < numStreams; ++stream)
+            {
+                _readAheads.emplace_back(new MappedReadAhead(
+                    data + (stream * streamSize),
+                    streamSize,
+                    _array.filepath(),
+                    _array.dataOffset() + (stream * streamSize),
+                    size_t(_readAheadMB * (1 << 20)),
+                    _dropReadPages,
+                    _prefetchThread));
+            }
+        }
+
+        void deactivate() override
+        {
+            for(const auto& readAhead: _readAheads) _droppedBytes += readAhead->droppedBytes();
+            _readAheads.clear();
+        }
+
+        void work() override
+        {
+            const auto elems = this->windowElements(this->workInfo().minAllOutElements);
+            if(!this->countWork(elems)) return;
+
+            const auto pos = this->position();
+            const auto streamPos = pos * (_array.isInterleaved() ? _array.numChannels() : 1) * _array.dtype().elemSize();
+            for(auto& readAhead: _readAheads) readAhead->update(streamPos);
+
+            if(_array.canPostInPlace())
+            {
+                _array.postChannels(this->outputs(), pos, elems);
+            }
+            else
+            {
+                this->timeCopy([&](){_array.copyChannels(this->outputs(), pos, elems);});
+                for(auto* output: this->outputs()) output->produce(elems);
+            }
+
+            this->advance(elems);
+            this->countElements(0, elems);
+        }
+
+    protected:
+        // Sets up one output per channel.
+        void setArray(const MappedArray& array)
+        {
+            _array = array;
+            this->setNumElements(array.numElements());
+
+            for(size_t chan = 0; chan < array.numChannels(); ++chan)
+            {
+                this->setupOutput(chan, array.dtype());
+            }
+        }
+
+    private:
+        std::string _filepath;
+        MappedArray _array;
+
+        double _readAheadMB;
+        bool _dropReadPages;
+        bool _prefetchThread;
+        std::vector<std::unique_ptr<MappedReadAhead>> _readAheads;
+        size_t _droppedBytes;
+
+};
+
+}
@@ -0,0 +1,276 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace PothosNumPy
+{
+
+//
+// Keeps a memory-mapped region paged in ahead of a sequential reader, so a
+// cold file is read at the disk's rate instead of one page fault at a time.
+//
+// The kernel is asked to read ahead of the read position, and optionally to
+// drop pages that are well behind it, both from this process and from the
+// page cache, so replaying a file larger than RAM doesn't push everything
+// else out of memory. Dropped pages are read from the file again if they're
+// accessed, so this never affects the data, only how long it takes to get
+// it.
+//
+// The madvise() hints are only used on POSIX systems. Elsewhere, only the
+// prefetch thread is used.
+//
+
+namespace detail
+{
+    enum class MappedAdvice
+    {
+        Sequential,
+        WillNeed,
+        DontNeed
+    };
+
+    static inline size_t getPageSize()
+    {
+#ifdef _WIN32
+        return 4096;
+#else
+        static const size_t pageSize = size_t(::sysconf(_SC_PAGESIZE));
+        return pageSize;
+#endif
+    }
+
+    // Only whole pages are dropped, so the range is shrunk to page
+    // boundaries instead of grown. Returns the number of bytes advised, or 0
+    // if the advice was refused.
+    static inline size_t adviseMapped(
+        const char* begin,
+        const char* end,
+        const MappedAdvice advice)
+    {
+#ifdef _WIN32
+        (void)begin;
+        (void)end;
+        (void)advice;
+        return 0;
+#else
+        const auto pageSize = getPageSize();
+        const bool shrink = (MappedAdvice::DontNeed == advice);
+
+        auto pageBegin = std::uintptr_t(begin) & ~std::uintptr_t(pageSize-1);
+        auto pageEnd = (std::uintptr_t(end) + pageSize - 1) & ~std::uintptr_t(pageSize-1);
+        if(shrink)
+        {
+            if(pageBegin < std::uintptr_t(begin)) pageBegin += pageSize;
+            if(pageEnd > std::uintptr_t(end))     pageEnd -= pageSize;
+        }
+        if(pageEnd <= pageBegin) return 0;
+
+        auto* addr = reinterpret_cast<void*>(pageBegin);
+        const size_t size = pageEnd - pageBegin;
+
+        // glibc makes POSIX_MADV_DONTNEED a no-op, since Linux discards
+        // changes to private mappings instead of just releasing them. The
+        // mapping is read-only, so nothing can be lost.
+        if(MappedAdvice::DontNeed == advice)
+        {
+            return (0 == ::madvise(addr, size, MADV_DONTNEED)) ? size : 0;
+        }
+
+        const int posixAdvice = (MappedAdvice::Sequential == advice) ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_WILLNEED;
+
+        // These are only hints, so failures are ignored.
+        return (0 == ::posix_madvise(addr, size, posixAdvice)) ? size : 0;
+#endif
+    }
+
+    // Once no process maps them, dropped pages can also be evicted from the
+    // page cache. Where posix_fadvise() isn't available, they're left for
+    // the kernel to evict.
+    static inline void dropCachedFile(
+        const int fd,
+        const std::uint64_t offset,
+        const size_t size)
+    {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+        if(fd >= 0) (void)::posix_fadvise(fd, off_t(offset), off_t(size), POSIX_FADV_DONTNEED);
+#else
+        (void)fd;
+        (void)offset;
+        (void)size;
+#endif
+    }
+}
+
+class MappedReadAhead
+{
+    public:
+        // data is mapped from filepath, starting fileOffset bytes in. The file
+        // is only opened to evict dropped pages from the page cache.
+        MappedReadAhead(
+            const char* data,
+            const size_t size,
+            const std::string& filepath,
+            const std::uint64_t fileOffset,
+            const size_t readAheadSize,
+            const bool dropReadPages,
+            const bool usePrefetchThread
+        ):
+            _data(data),
+            _size(size),
+            _fileOffset(fileOffset),
+            _fd(-1),
+            _readAheadSize(std::max(readAheadSize, detail::getPageSize())),
+            _dropReadPages(dropReadPages),
+            _lastPos(0),
+            _advisedEnd(0),
+            _droppedEnd(0),
+            _droppedBytes(0),
+            _prefetchTarget(0),
+            _prefetchedEnd(0),
+            _stopping(false)
+        {
+            (void)detail::adviseMapped(_data, _data + _size, detail::MappedAdvice::Sequential);
+
+#ifndef _WIN32
+            if(_dropReadPages) _fd = ::open(filepath.c_str(), O_RDONLY);
+#else
+            (void)filepath;
+#endif
+
+            if(usePrefetchThread) _thread = std::thread(&MappedReadAhead::prefetchLoop, this);
+        }
+
+        virtual ~MappedReadAhead()
+        {
+            if(_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stopping = true;
+                }
+                _cond.notify_one();
+
+                _thread.join();
+            }
+
+#ifndef _WIN32
+            if(_fd >= 0) ::close(_fd);
+#endif
+        }
+
+        // The number of bytes released from this process's memory so far
+        size_t droppedBytes() const
+        {
+            return _droppedBytes;
+        }
+
+        // Call with the byte offset of the next read, before reading.
+        void update(const size_t pos)
+        {
+            // After a seek backwards or a repeat, start over from here.
+            if(pos < _lastPos)
+            {
+                _advisedEnd = pos;
+                _droppedEnd = pos;
+            }
+            _lastPos = pos;
+
+            // Ask for the next window once half of the current one is used,
+            // so the disk always has outstanding reads.
+            if((pos + (_readAheadSize / 2)) >= _advisedEnd)
+            {
+                const auto begin = std::max(pos, _advisedEnd);
+                _advisedEnd = std::min(pos + _readAheadSize, _size);
+
+                if(begin < _advisedEnd)
+                {
+                    (void)detail::adviseMapped(_data + begin, _data + _advisedEnd, detail::MappedAdvice::WillNeed);
+
+                    if(_thread.joinable()) this->setPrefetchTarget(begin, _advisedEnd);
+                }
+            }
+
+            // Buffers posted downstream may still be in use, so a window's
+            // worth of pages is kept behind the read position.
+            if(_dropReadPages && (pos >= (_droppedEnd + (2 * _readAheadSize))))
+            {
+                const auto end = pos - _readAheadSize;
+                _droppedBytes += detail::adviseMapped(_data + _droppedEnd, _data + end, detail::MappedAdvice::DontNeed);
+                detail::dropCachedFile(_fd, _fileOffset + _droppedEnd, end - _droppedEnd);
+                _droppedEnd = end;
+            }
+        }
+
+    private:
+        const char* _data;
+        size_t _size;
+        std::uint64_t _fileOffset;
+        int _fd;
+        size_t _readAheadSize;
+        bool _dropReadPages;
+
+        // Only used by the reader's thread
+        size_t _lastPos;
+        size_t _advisedEnd;
+        size_t _droppedEnd;
+        size_t _droppedBytes;
+
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        size_t _prefetchTarget;
+        size_t _prefetchedEnd;
+        bool _stopping;
+
+        void setPrefetchTarget(const size_t begin, const size_t end)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                // A jump moves the prefetcher with it.
+                if((begin < _prefetchedEnd) || (begin > _prefetchTarget)) _prefetchedEnd = begin;
+                _prefetchTarget = end;
+            }
+            _cond.notify_one();
+        }
+
+        // Touch one byte per page, so the pages are read even where the
+        // kernel ignores the hints.
+        void prefetchLoop()
+        {
+            const auto pageSize = detail::getPageSize();
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while(true)
+            {
+                _cond.wait(lock, [this](){return _stopping || (_prefetchedEnd < _prefetchTarget);});
+                if(_stopping) return;
+
+                const auto begin = _prefetchedEnd;
+                const auto end = std::min(begin + pageSize, _prefetchTarget);
+                _prefetchedEnd = end;
+
+                // Don't hold the lock during a page fault.
+                lock.unlock();
+                (void)*reinterpret_cast<const volatile char*>(_data + begin);
+                lock.lock();
+            }
+        }
+};
+
+}
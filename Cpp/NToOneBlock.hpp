@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/Kernels.hpp"
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <cstring>
+#include <string>
+#include <typeinfo>
+
+namespace PothosNumPy
+{
+
+//
+// Native equivalent of NToOneBlock.py for reductions of a binary function
+// over all inputs. Rather than allocating a temporary per step, the first two
+// inputs are combined into the output buffer, and each subsequent input is
+// accumulated into it in place.
+//
+
+template <typename Func>
+class NToOneBlock: public BaseBlock
+{
+    public:
+        using InType = typename Func::InType;
+        using OutType = typename Func::OutType;
+
+        // Factory parameters: (dtype, nchans)
+        static Pothos::Block* make(
+            const std::string& blockPath,
+            const Pothos::Object* args,
+            const size_t numArgs)
+        {
+            return (2 == numArgs) ? new NToOneBlock(blockPath, args[1].convert<size_t>()) : nullptr;
+        }
+
+        NToOneBlock(const std::string& blockPath, const size_t nchans):
+            BaseBlock(blockPath),
+            _nchans(0)
+        {
+            this->registerCall(this, POTHOS_FCN_TUPLE(NToOneBlock, numChannels));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NToOneBlock, setNumChannels));
+
+            this->setNumChannels(nchans);
+            this->setupOutput(0, Pothos::DType(typeid(OutType)));
+        }
+
+        virtual ~NToOneBlock() = default;
+
+        size_t numChannels() const
+        {
+            return _nchans;
+        }
+
+        void setNumChannels(const size_t nchans)
+        {
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+
+            for(size_t chan = _nchans; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, Pothos::DType(typeid(InType)));
+            }
+
+            _nchans = nchans;
+        }
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllElements;
+            if(!this->countWork(elems)) return;
+
+            const auto& inputs = this->inputs();
+            auto output = this->output(0);
+            OutType* buffOut = output->buffer();
+
+            if(1 == inputs.size())
+            {
+                this->timeCopy([&]()
+                {
+                    std::memcpy(buffOut, inputs[0]->buffer().template as<const void*>(), elems*sizeof(OutType));
+                });
+            }
+            else
+            {
+                this->timeFunc([&]()
+                {
+                    BinaryKernel<Func>::run(
+                        inputs[0]->buffer(),
+                        inputs[1]->buffer(),
+                        buffOut,
+                        elems);
+
+                    for(size_t chan = 2; chan < inputs.size(); ++chan)
+                    {
+                        BinaryKernel<Func>::accumulate(
+                            inputs[chan]->buffer(),
+                            buffOut,
+                            elems);
+                    }
+                });
+            }
+
+            for(auto* input: inputs) input->consume(elems);
+            output->produce(elems);
+            this->countElements(elems, elems);
+        }
+
+    private:
+        size_t _nchans;
+};
+
+}
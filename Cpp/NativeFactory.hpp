@@ -0,0 +1,47 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <string>
+#include <typeinfo>
+
+namespace PothosNumPy
+{
+
+//
+// Given a list of types from a block's YAML entry, instantiate the native
+// block whose input type matches the given DType. The remaining factory
+// parameters are passed to the block class's make() function. This returns
+// nullptr if there is no match so the caller can fall back to the Python
+// implementation, which will report the error for unsupported types.
+//
+
+template <template <typename> class BlockClass, template <typename> class Func>
+static Pothos::Block* makeNativeBlock(
+    const std::string&,
+    const Pothos::DType&,
+    const Pothos::Object*,
+    const size_t)
+{
+    return nullptr;
+}
+
+template <template <typename> class BlockClass, template <typename> class Func, typename T, typename... Types>
+static Pothos::Block* makeNativeBlock(
+    const std::string& blockPath,
+    const Pothos::DType& dtype,
+    const Pothos::Object* args,
+    const size_t numArgs)
+{
+    static const Pothos::DType ThisDType(typeid(typename Func<T>::InType));
+
+    if(dtype == ThisDType) return BlockClass<Func<T>>::make(blockPath, args, numArgs);
+    else return makeNativeBlock<BlockClass, Func, Types...>(blockPath, dtype, args, numArgs);
+}
+
+}
@@ -0,0 +1,610 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/FileSinkBlock.hpp"
+#include "Cpp/NpyFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+#include <Poco/Logger.h>
+#include <Poco/Path.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// Streams samples to disk as they arrive, through a background writer. The
+// header is written up front with room for any shape, and the shape is filled
+// in when the block is deactivated, so memory use is constant regardless of
+// the capture length.
+//
+// Multiple channels are written as a 2D array of shape (nchans, N). It is
+// stored in Fortran order, where each sample's channels are stored
+// together, so all channels can be streamed to the same file as they
+// arrive.
+//
+// In segmented mode, the capture is split across a series of files. Each
+// segment is written with a ".part" suffix, then finished on a background
+// thread, which fills in its shape, closes it, and renames it, so anything
+// with a .npy extension is complete. Only one segment is finished at a time,
+// which bounds how much memory the writers use.
+//
+
+class NpyFileSink: public PothosNumPy::FileSinkBlock
+{
+    public:
+        NpyFileSink(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const size_t nchans,
+            const bool append
+        ):
+            PothosNumPy::FileSinkBlock("/numpy/npy_sink"),
+            _filepath(filepath),
+            _descr(PothosNumPy::dtypeToNpyDescr(dtype)),
+            _elemSize(dtype.elemSize()),
+            _append(append),
+            _numChannels(nchans),
+            _dataOffset(0),
+            _numElements(0),
+            _segmentSamples(0),
+            _segmentSeconds(0.0),
+            _segmentNaming("numbered"),
+            _segmenting(false),
+            _segmentIndex(0)
+        {
+            if(Poco::Path(filepath).getExtension() != "npy")
+            {
+                throw Pothos::InvalidArgumentException("Only .npy files are supported.", filepath);
+            }
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+
+            // If we're appending, make sure what's there matches our given
+            // DType and is of the correct type.
+            if(_append && Poco::File(_filepath).exists()) this->readExistingHeader();
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, append));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, segmentSamples));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, setSegmentSamples));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, segmentSeconds));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, setSegmentSeconds));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, segmentLabel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, setSegmentLabel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, segmentNaming));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, setSegmentNaming));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, numSegments));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyFileSink, lastSegmentPath));
+            this->registerProbe("numSegments");
+            this->registerProbe("lastSegmentPath");
+            this->setupSeriesSignal("segmentFinished");
+
+            for(size_t chan = 0; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, dtype);
+            }
+        }
+
+        virtual ~NpyFileSink() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        bool append() const
+        {
+            return _append;
+        }
+
+        // Segmenting is turned on or off the next time the block is
+        // activated. Otherwise, changes apply to the current segment.
+        // 0 disables rolling over by sample count.
+        size_t segmentSamples() const
+        {
+            return _segmentSamples;
+        }
+
+        void setSegmentSamples(const size_t segmentSamples)
+        {
+            _segmentSamples = segmentSamples;
+        }
+
+        // 0 disables rolling over by time.
+        double segmentSeconds() const
+        {
+            return _segmentSeconds;
+        }
+
+        void setSegmentSeconds(const double segmentSeconds)
+        {
+            if(segmentSeconds < 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Segment length cannot be negative.");
+            }
+
+            _segmentSeconds = segmentSeconds;
+        }
+
+        // An empty label disables rolling over on labels.
+        std::string segmentLabel() const
+        {
+            return _segmentLabel;
+        }
+
+        void setSegmentLabel(const std::string& segmentLabel)
+        {
+            _segmentLabel = segmentLabel;
+        }
+
+        std::string segmentNaming() const
+        {
+            return _segmentNaming;
+        }
+
+        void setSegmentNaming(const std::string& segmentNaming)
+        {
+            PothosNumPy::checkSeriesNaming(segmentNaming);
+            _segmentNaming = segmentNaming;
+        }
+
+        // Segments finished since the block was last activated
+        size_t numSegments() const
+        {
+            return this->numSeriesFiles();
+        }
+
+        std::string lastSegmentPath() const
+        {
+            return this->lastSeriesFilePath();
+        }
+
+        void activate() override
+        {
+            _segmenting = (_segmentSamples > 0) || (_segmentSeconds > 0.0) || !_segmentLabel.empty();
+            if(_segmenting)
+            {
+                _segmentIndex = 0;
+                this->resetSeries();
+
+                this->startSegment();
+            }
+            else
+            {
+                // Validate again in case the file changed since construction.
+                if(_append && Poco::File(_filepath).exists()) this->readExistingHeader();
+
+                // The file isn't touched until there's something to write.
+                _file.reset();
+            }
+        }
+
+        void deactivate() override
+        {
+            if(_segmenting)
+            {
+                this->finishSegment();
+                this->waitForSeriesFile();
+                return;
+            }
+
+            if(!_file) return;
+
+            // If an appended file's header doesn't have room for the new
+            // shape, the data must be moved, which is only done once.
+            const auto header = PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset);
+            if(header.size() == _dataOffset) _file->writeAt(0, header.data(), header.size());
+
+            _file->close();
+
+            if(header.size() != _dataOffset) this->moveData(header);
+        }
+
+        void work() override
+        {
+            auto elems = this->workInfo().minAllInElements;
+            if(_segmenting)
+            {
+                this->waitForSeriesFile(false);
+
+                // Segments are only rolled over once there's something to
+                // write, so the last one is never empty.
+                if((elems > 0) && this->isSegmentDone())
+                {
+                    this->timeFunc([&]()
+                    {
+                        this->finishSegment();
+                        ++_segmentIndex;
+                        this->startSegment();
+                    });
+                }
+
+                elems = std::min(elems, this->segmentRoom());
+            }
+            if(!this->countWork(elems)) return;
+
+            const auto& inputs = this->inputs();
+            this->timeFunc([&]()
+            {
+                if(!_file) this->openOutputFile();
+
+                std::vector<const char*> channels;
+                for(auto* input: inputs) channels.emplace_back(input->buffer().as<const char*>());
+
+                PothosNumPy::writeChannels(*_file, channels, elems, _elemSize, _interleaveBuffer);
+            });
+
+            for(auto* input: inputs) input->consume(elems);
+            _numElements += elems;
+            this->countElements(elems, 0);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _descr;
+        size_t _elemSize;
+        bool _append;
+        size_t _numChannels;
+
+        size_t _dataOffset;
+
+        // Per channel
+        size_t _numElements;
+
+        std::vector<char> _interleaveBuffer;
+        std::unique_ptr<PothosNumPy::AsyncFileWriter> _file;
+
+        size_t _segmentSamples;
+        double _segmentSeconds;
+        std::string _segmentLabel;
+        std::string _segmentNaming;
+
+        bool _segmenting;
+        size_t _segmentIndex;
+        std::string _segmentPath;
+        std::chrono::steady_clock::time_point _segmentStartTime;
+
+        const PothosNumPy::AsyncFileWriter* fileWriter() const override
+        {
+            return _file.get();
+        }
+
+        // Opens the file on the first write, either appending to it or
+        // replacing it.
+        void openOutputFile()
+        {
+            if(_append && Poco::File(_filepath).exists())
+            {
+                const auto header = this->readExistingHeader();
+                _dataOffset = header.dataOffset;
+                _numElements = header.shape.back();
+
+                // A capture that was interrupted leaves samples past the shape
+                // in its header, which may still be the placeholder (0,).
+                // They're kept, and the header is corrected on close.
+                const auto fileSize = Poco::File(_filepath).getSize();
+                const size_t frameSize = _numChannels * _elemSize;
+                const size_t fileElements = size_t((fileSize - _dataOffset) / frameSize);
+                if(fileElements > _numElements)
+                {
+                    poco_warning(
+                        Poco::Logger::get(this->getName()),
+                        "Recovered "+std::to_string(fileElements - _numElements)+" samples past the end of the array in "+_filepath);
+                    _numElements = fileElements;
+                }
+
+                // Only a partial sample at the end can't be recovered.
+                if(fileSize > this->getFileSize())
+                {
+                    poco_warning(
+                        Poco::Logger::get(this->getName()),
+                        "Dropping a partial sample ("+std::to_string(fileSize - this->getFileSize())+" bytes) at the end of "+_filepath);
+                    Poco::File(_filepath).setSize(this->getFileSize());
+                }
+
+                _file = this->openFile(_filepath, false);
+                _file->seek(this->getFileSize());
+            }
+            else
+            {
+                _dataOffset = PothosNumPy::getGrowableChannelsNpyHeaderSize(_descr, _numChannels);
+                _numElements = 0;
+
+                _file = this->openFile(_filepath, true);
+                _file->write(PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset).data(), _dataOffset);
+            }
+        }
+
+        std::unique_ptr<PothosNumPy::AsyncFileWriter> openFile(
+            const std::string& filepath,
+            const bool truncate) const
+        {
+            return std::unique_ptr<PothosNumPy::AsyncFileWriter>(new PothosNumPy::AsyncFileWriter(
+                       filepath,
+                       truncate,
+                       this->fileSyncMode(),
+                       this->fileSyncInterval()));
+        }
+
+        void startSegment()
+        {
+            _segmentPath = PothosNumPy::makeSeriesFilepath(_filepath, _segmentNaming, _segmentIndex);
+            _dataOffset = PothosNumPy::getGrowableChannelsNpyHeaderSize(_descr, _numChannels);
+            _numElements = 0;
+
+            _file = this->openFile(_segmentPath + ".part", true);
+            _file->write(PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset).data(), _dataOffset);
+
+            _segmentStartTime = std::chrono::steady_clock::now();
+        }
+
+        // New files always have room for the shape, so the header is
+        // rewritten in place.
+        void finishSegment()
+        {
+            const auto header = PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset);
+            _file->writeAt(0, header.data(), header.size());
+
+            this->finishSeriesFile(std::move(_file), _segmentPath);
+        }
+
+        // The first index at or after minIndex with a segment label on any
+        // input, if any
+        size_t findSegmentLabel(const size_t minIndex) const
+        {
+            auto labelIndex = std::numeric_limits<size_t>::max();
+            if(_segmentLabel.empty()) return labelIndex;
+
+            for(const auto* input: this->inputs())
+            {
+                for(const auto& label: input->labels())
+                {
+                    if((label.id == _segmentLabel) && (label.index >= minIndex))
+                    {
+                        labelIndex = std::min(labelIndex, size_t(label.index));
+                    }
+                }
+            }
+
+            return labelIndex;
+        }
+
+        // A labelled sample starts the next segment.
+        bool isSegmentDone() const
+        {
+            if(0 == _numElements) return false;
+
+            if((_segmentSamples > 0) && (_numElements >= _segmentSamples)) return true;
+            if(_segmentSeconds > 0.0)
+            {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _segmentStartTime;
+                if(elapsed.count() >= _segmentSeconds) return true;
+            }
+
+            return (0 == this->findSegmentLabel(0));
+        }
+
+        // How many samples can be written before the segment must end
+        size_t segmentRoom() const
+        {
+            auto room = this->findSegmentLabel(1);
+            if(_segmentSamples > 0) room = std::min(room, _segmentSamples - _numElements);
+
+            return room;
+        }
+
+        size_t getFileSize() const
+        {
+            return _dataOffset + (_numChannels * _numElements * _elemSize);
+        }
+
+        PothosNumPy::NpyHeader readExistingHeader() const
+        {
+            std::ifstream stream(_filepath, std::ios::in | std::ios::binary);
+            if(!stream)
+            {
+                throw Pothos::OpenFileException("Failed to open file for reading", _filepath);
+            }
+
+            const auto header = PothosNumPy::readNpyHeader(stream, _filepath);
+            if(1 == _numChannels)
+            {
+                if(1 != header.shape.size())
+                {
+                    throw Pothos::DataFormatException("Single-channel data can only be appended to 1D arrays.", _filepath);
+                }
+            }
+            else
+            {
+                if(2 != header.shape.size())
+                {
+                    throw Pothos::DataFormatException("Multi-channel data can only be appended to 2D arrays.", _filepath);
+                }
+                if(_numChannels != header.shape[0])
+                {
+                    throw Pothos::InvalidArgumentException(
+                              "Mismatched # channels: "+std::to_string(_numChannels)+" vs "+std::to_string(header.shape[0]));
+                }
+
+                // C-order arrays store each channel contiguously, so they
+                // can't be extended without rewriting the file.
+                if(!header.fortranOrder)
+                {
+                    throw Pothos::DataFormatException("Multi-channel data can only be appended to Fortran-order arrays.", _filepath);
+                }
+            }
+            if(header.descr != _descr)
+            {
+                throw Pothos::InvalidArgumentException("Mismatched dtypes: "+_descr+" vs "+header.descr);
+            }
+
+            const auto fileSize = Poco::File(_filepath).getSize();
+            if(fileSize < (header.dataOffset + (_numChannels * header.shape.back() * _elemSize)))
+            {
+                throw Pothos::DataFormatException("File is smaller than its header indicates", _filepath);
+            }
+
+            return header;
+        }
+
+        // Rewrite the file with the given header, which is larger than the
+        // existing one.
+        void moveData(const std::string& header)
+        {
+            const auto tempFilepath = _filepath + ".tmp";
+
+            {
+                std::ifstream input(_filepath, std::ios::in | std::ios::binary);
+                input.seekg(_dataOffset);
+
+                // Written the same way as the original, so it's synced the
+                // same way.
+                auto output = this->openFile(tempFilepath, true);
+                output->write(header.data(), header.size());
+
+                std::vector<char> buffer(1 << 20);
+                while(input.read(buffer.data(), buffer.size()) || (input.gcount() > 0))
+                {
+                    output->write(buffer.data(), size_t(input.gcount()));
+                }
+                if(input.bad())
+                {
+                    throw Pothos::WriteFileException("Failed to rewrite file", _filepath);
+                }
+
+                output->close();
+            }
+
+            Poco::File(tempFilepath).renameTo(_filepath);
+            _dataOffset = header.size();
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc .npy File Sink
+ *
+ * Corresponding NumPy function: <b>numpy.save</b>
+ *
+ * Samples are streamed to disk as they arrive, so memory use does not
+ * grow with the length of the capture. The array's shape is written to
+ * the file's header when the topology stops. When appending, the existing
+ * file's header is updated in place, and its contents are not loaded.
+ * Samples past the end of the existing array, such as from a capture that
+ * was interrupted before its header was written, are kept. The file is not
+ * created or replaced until the first sample arrives.
+ *
+ * Samples are written to disk on a background thread, so disk latency only
+ * stalls the topology once every write buffer is full. The writeQueueDepth
+ * and writeBlockedSeconds probes show how well the disk is keeping up.
+ *
+ * A single channel is written as a 1D array. Multiple channels are written
+ * as a Fortran-order 2D array with one row per channel, which is loaded
+ * the same as any other 2D array.
+ *
+ * In segmented mode, the capture is split into a series of files, each of
+ * which is finished and readable while the capture continues. A new
+ * segment is started every <b>segmentSamples</b> samples per channel,
+ * every <b>segmentSeconds</b> seconds, or at each sample with the label
+ * <b>segmentLabel</b>, whichever comes first. Segmented mode is enabled by
+ * setting any of these.
+ *
+ * Segments are named after the filepath, with either a sequence number or
+ * the UTC time the segment started, as in <b>capture_000000.npy</b> or
+ * <b>capture_20230102T030405.678901Z.npy</b>. The segment being written has
+ * a <b>.part</b> suffix until it's finished, so any file ending in .npy is
+ * complete. Each finished segment's path is emitted by the
+ * <b>segmentFinished</b> signal. Existing files are not appended to in
+ * segmented mode.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sinks/NumPy
+ * |keywords save numpy binary file IO
+ * |factory /numpy/npy_sink(filepath,dtype,nchans,append)
+ * |setter setSyncMode(syncMode)
+ * |setter setSyncIntervalMB(syncIntervalMB)
+ * |setter setSegmentSamples(segmentSamples)
+ * |setter setSegmentSeconds(segmentSeconds)
+ * |setter setSegmentLabel(segmentLabel)
+ * |setter setSegmentNaming(segmentNaming)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Channels] The number of inputs.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param append[Append?]
+ * |default false
+ * |widget ToggleSwitch(on="True",off="False")
+ * |preview enable
+ *
+ * |param syncMode[Sync Mode] When the file is flushed to disk. Only this file is synced, not the whole filesystem.
+ * |option [Never] "never"
+ * |option [On Close] "close"
+ * |option [Every N MB] "interval"
+ * |widget ComboBox(editable=false)
+ * |default "close"
+ * |preview disable
+ *
+ * |param syncIntervalMB[Sync Interval] How much is written between syncs in the "Every N MB" mode.
+ * |widget DoubleSpinBox(minimum=1)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ *
+ * |param segmentSamples[Segment Samples] Start a new segment after this many samples per channel. 0 disables this.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ *
+ * |param segmentSeconds[Segment Length] Start a new segment after this long. 0 disables this.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |units seconds
+ * |preview disable
+ *
+ * |param segmentLabel[Segment Label] Start a new segment at each sample with this label. Empty disables this.
+ * |widget StringEntry()
+ * |default ""
+ * |preview disable
+ *
+ * |param segmentNaming[Segment Naming] How segment filenames are made unique.
+ * |option [Numbered] "numbered"
+ * |option [Timestamp] "timestamp"
+ * |widget ComboBox(editable=false)
+ * |default "numbered"
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeNpyFileSink(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const size_t nchans,
+    const bool append)
+{
+    return new NpyFileSink(filepath, dtype, nchans, append);
+}
+
+static Pothos::BlockRegistry registerNumPyNpySink(
+    "/numpy/npy_sink",
+    Pothos::Callable(&makeNpyFileSink));
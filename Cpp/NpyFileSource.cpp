@@ -0,0 +1,109 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/MappedArray.hpp"
+#include "Cpp/MappedFileSource.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <string>
+
+//
+// Plays the array straight out of a memory mapping. Big-endian files and
+// Fortran-order 2D arrays can't be used as-is, so they are copied into the
+// output buffers instead.
+//
+
+class NpyFileSource: public PothosNumPy::MappedFileSource
+{
+    public:
+        NpyFileSource(const std::string& filepath, const bool repeat):
+            PothosNumPy::MappedFileSource("/numpy/npy_source", filepath, repeat)
+        {
+            this->setArray(PothosNumPy::MappedArray::fromNpyFile(filepath));
+        }
+
+        virtual ~NpyFileSource() = default;
+};
+
+/***********************************************************************
+ * |PothosDoc .npy File Source
+ *
+ * Corresponding NumPy function: <b>numpy.load</b> (with .npy extension)
+ *
+ * The file is memory-mapped, and the output buffers point directly into
+ * the mapping, so samples are not copied unless the file is big-endian or
+ * a Fortran-order 2D array.
+ *
+ * Playback can be limited to <b>count</b> samples starting at
+ * <b>startIndex</b>, and repeat mode loops over just that window. Moving
+ * the window doesn't read the file, so a short segment of a very large
+ * recording starts playing immediately. At runtime, the <b>seek</b> slot
+ * moves playback to any index within the window.
+ *
+ * By default, pages are read from disk as they're first accessed, which
+ * is slow for files that aren't already cached. Setting <b>readAheadMB</b>
+ * asks the OS to read that far ahead of playback. For recordings larger
+ * than memory, <b>dropReadPages</b> releases pages once playback is well
+ * past them, and the droppedReadMB probe shows how much was released.
+ * <b>prefetchThread</b> reads ahead on a separate thread for systems that
+ * ignore read-ahead hints.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sources/NumPy
+ * |keywords load numpy binary file IO mmap
+ * |factory /numpy/npy_source(filepath,repeat)
+ * |setter setRepeat(repeat)
+ * |setter setStartIndex(startIndex)
+ * |setter setCount(count)
+ * |setter setReadAheadMB(readAheadMB)
+ * |setter setDropReadPages(dropReadPages)
+ * |setter setPrefetchThread(prefetchThread)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=open)
+ * |default ""
+ * |preview enable
+ *
+ * |param repeat[Repeat?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ *
+ * |param startIndex[Start Index] The first sample to output, per channel.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param count[Count] The number of samples to output, per channel. 0 outputs everything after the start index.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param readAheadMB[Read-Ahead] How far ahead of playback to read, per channel. 0 disables read-ahead.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |units MB
+ * |preview disable
+ *
+ * |param dropReadPages[Drop Read Pages?] Release pages from memory once playback is past them.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview disable
+ *
+ * |param prefetchThread[Prefetch Thread?] Read ahead on a background thread.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeNpyFileSource(
+    const std::string& filepath,
+    const bool repeat)
+{
+    return new NpyFileSource(filepath, repeat);
+}
+
+static Pothos::BlockRegistry registerNumPyNpySource(
+    "/numpy/npy_source",
+    Pothos::Callable(&makeNpyFileSource));
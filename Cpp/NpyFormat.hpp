@@ -0,0 +1,529 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework/DType.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// Reading and writing .npy headers, as described in numpy.lib.format.
+// Only simple numeric types are supported. Files are written little-endian,
+// matching the platforms Pothos runs on, but big-endian files can be read.
+//
+
+struct NpyHeader
+{
+    std::string descr;
+    bool fortranOrder;
+    std::vector<size_t> shape;
+
+    // The number of bytes before the array data
+    size_t dataOffset;
+};
+
+namespace detail
+{
+    static const std::string NpyMagic("\x93NUMPY", 6);
+
+    // Headers are padded to a multiple of this so the data is aligned.
+    static constexpr size_t NpyHeaderAlignment = 64;
+
+    // Enough to hold any dimension, so a header can be rewritten in place as
+    // the array grows.
+    static constexpr size_t NpyMaxDimDigits = 21;
+
+    static inline size_t findNpyDictValue(const std::string& dict, const std::string& key)
+    {
+        const auto keyPos = dict.find("'"+key+"'");
+        if(std::string::npos == keyPos)
+        {
+            throw Pothos::DataFormatException("Invalid .npy header: missing key", key);
+        }
+
+        auto pos = dict.find(':', keyPos);
+        if(std::string::npos == pos)
+        {
+            throw Pothos::DataFormatException("Invalid .npy header: missing value", key);
+        }
+
+        ++pos;
+        while((pos < dict.size()) && std::isspace(static_cast<unsigned char>(dict[pos]))) ++pos;
+
+        return pos;
+    }
+
+    static inline std::string formatNpyShape(const std::vector<size_t>& shape)
+    {
+        std::string ret = "(";
+        for(size_t dim = 0; dim < shape.size(); ++dim)
+        {
+            if(dim > 0) ret += ", ";
+            ret += std::to_string(shape[dim]);
+        }
+        if(1 == shape.size()) ret += ",";
+        ret += ")";
+
+        return ret;
+    }
+
+    static inline std::string makeNpyDict(
+        const std::string& descr,
+        const bool fortranOrder,
+        const std::string& shapeStr)
+    {
+        return "{'descr': '" + descr + "', "
+             + "'fortran_order': " + (fortranOrder ? "True" : "False") + ", "
+             + "'shape': " + shapeStr + ", }";
+    }
+
+    // The total size of a header with the given dictionary, including the
+    // preamble and the terminating newline
+    static inline size_t getNpyHeaderSize(const size_t dictSize)
+    {
+        // Leave room for a version 2.0 preamble, which has a 32-bit length.
+        const size_t minSize = NpyMagic.size() + 2 + 4 + dictSize + 1;
+
+        return ((minSize + NpyHeaderAlignment - 1) / NpyHeaderAlignment) * NpyHeaderAlignment;
+    }
+
+    static inline std::vector<size_t> parseNpyShape(const std::string& shapeStr)
+    {
+        std::vector<size_t> ret;
+
+        size_t pos = 0;
+        while(pos < shapeStr.size())
+        {
+            auto end = shapeStr.find(',', pos);
+            if(std::string::npos == end) end = shapeStr.size();
+
+            const auto dimStr = shapeStr.substr(pos, end-pos);
+            if(std::string::npos != dimStr.find_first_not_of(" \t"))
+            {
+                try
+                {
+                    ret.emplace_back(std::stoull(dimStr));
+                }
+                catch(const std::exception&)
+                {
+                    throw Pothos::DataFormatException("Invalid .npy header: invalid shape", shapeStr);
+                }
+            }
+
+            pos = end+1;
+        }
+
+        return ret;
+    }
+
+    template <size_t ElemSize>
+    static inline void interleaveChannel(
+        const char* in,
+        char* out,
+        const size_t numElems,
+        const size_t numChannels)
+    {
+        const size_t outStride = numChannels * ElemSize;
+        for(size_t elem = 0; elem < numElems; ++elem)
+        {
+            std::memcpy(out + (elem * outStride), in + (elem * ElemSize), ElemSize);
+        }
+    }
+
+    // The input is de-interleaved this many bytes at a time, so each block
+    // stays in the L1 cache while it's read once per channel, instead of
+    // the whole input being streamed from memory once per channel.
+    static constexpr size_t DeinterleaveBlockSize = 1 << 14;
+
+    template <size_t ElemSize>
+    static inline void deinterleaveChannels(
+        const char* in,
+        char* const* outs,
+        const size_t numElems,
+        const size_t numChannels)
+    {
+        const size_t inStride = numChannels * ElemSize;
+        const size_t blockElems = std::max<size_t>(DeinterleaveBlockSize / inStride, 1);
+
+        for(size_t blockStart = 0; blockStart < numElems; blockStart += blockElems)
+        {
+            const size_t blockEnd = std::min(blockStart + blockElems, numElems);
+            for(size_t chan = 0; chan < numChannels; ++chan)
+            {
+                const char* src = in + (blockStart * inStride) + (chan * ElemSize);
+                char* dst = outs[chan] + (blockStart * ElemSize);
+
+                for(size_t elem = blockStart; elem < blockEnd; ++elem)
+                {
+                    std::memcpy(dst, src, ElemSize);
+                    src += inStride;
+                    dst += ElemSize;
+                }
+            }
+        }
+    }
+}
+
+//
+// Type conversion
+//
+
+static inline std::string dtypeToNpyDescr(const Pothos::DType& dtype)
+{
+    if(dtype.dimension() > 1)
+    {
+        throw Pothos::InvalidArgumentException("PothosNumPy only supports DTypes of dimension 1.", dtype.toString());
+    }
+
+    char kind = '\0';
+    if(dtype.isComplex())      kind = dtype.isFloat() ? 'c' : '\0';
+    else if(dtype.isFloat())   kind = 'f';
+    else if(dtype.isInteger()) kind = dtype.isSigned() ? 'i' : 'u';
+
+    if('\0' == kind)
+    {
+        throw Pothos::InvalidArgumentException("NumPy does not support type", dtype.toString());
+    }
+
+    const size_t size = dtype.elemSize();
+    return std::string(1, (1 == size) ? '|' : '<') + kind + std::to_string(size);
+}
+
+static inline Pothos::DType npyDescrToDType(const std::string& descr)
+{
+    static const std::string UnsupportedError("Unsupported .npy type");
+
+    if((descr.size() < 3) || (std::string::npos == std::string("<>|=").find(descr[0])))
+    {
+        throw Pothos::DataFormatException(UnsupportedError, descr);
+    }
+
+    size_t size = 0;
+    try
+    {
+        size = std::stoul(descr.substr(2));
+    }
+    catch(const std::exception&)
+    {
+        throw Pothos::DataFormatException(UnsupportedError, descr);
+    }
+
+    const auto bits = std::to_string(size*8);
+    switch(descr[1])
+    {
+    case 'i':
+        return Pothos::DType("int"+bits);
+
+    case 'u':
+        return Pothos::DType("uint"+bits);
+
+    case 'f':
+        return Pothos::DType("float"+bits);
+
+    case 'c':
+        return Pothos::DType("complex_float"+std::to_string(size*4));
+
+    default:
+        throw Pothos::DataFormatException(UnsupportedError, descr);
+    }
+}
+
+// Big-endian data must be byteswapped before use. For complex types, each
+// component is swapped separately.
+static inline bool isNpyDescrByteSwapped(const std::string& descr)
+{
+    return (descr.size() > 2) && ('>' == descr[0]) && ("1" != descr.substr(2));
+}
+
+// The size of each word whose bytes are reversed to change the byte order,
+// which is also the alignment the type needs.
+static inline size_t getByteSwapWordSize(const Pothos::DType& dtype)
+{
+    return dtype.isComplex() ? (dtype.elemSize() / 2) : dtype.elemSize();
+}
+
+// For raw files, whose byte order is given by the user: "native", "little",
+// or "big".
+static inline bool isByteOrderSwapped(const std::string& byteOrder)
+{
+    static const std::uint16_t EndianCheck = 1;
+    const bool isLittleEndian = (1 == *reinterpret_cast<const std::uint8_t*>(&EndianCheck));
+
+    if("native" == byteOrder) return false;
+    if("little" == byteOrder) return !isLittleEndian;
+    if("big" == byteOrder)    return isLittleEndian;
+
+    throw Pothos::InvalidArgumentException("Invalid byte order", byteOrder);
+}
+
+//
+// Headers
+//
+
+// Returns everything before the array data, padded to at least minSize.
+static inline std::string makeNpyHeader(
+    const std::string& descr,
+    const bool fortranOrder,
+    const std::vector<size_t>& shape,
+    const size_t minSize = 0)
+{
+    auto dict = detail::makeNpyDict(descr, fortranOrder, detail::formatNpyShape(shape));
+
+    // Files written elsewhere may not use our alignment, so when patching a
+    // header in place, its existing size is used as-is.
+    const size_t totalSize = std::max(detail::getNpyHeaderSize(dict.size()), minSize);
+
+    // Version 1.0 stores the header length in 16 bits, and 2.0 in 32 bits.
+    const bool useVersion2 = ((totalSize - detail::NpyMagic.size() - 4) > std::numeric_limits<std::uint16_t>::max());
+    const size_t lengthSize = useVersion2 ? 4 : 2;
+    const size_t dictSize = totalSize - detail::NpyMagic.size() - 2 - lengthSize;
+
+    dict.resize(dictSize - 1, ' ');
+    dict += '\n';
+
+    std::string ret = detail::NpyMagic;
+    ret += char(useVersion2 ? 2 : 1);
+    ret += char(0);
+    for(size_t byte = 0; byte < lengthSize; ++byte)
+    {
+        ret += char((dictSize >> (8*byte)) & 0xFF);
+    }
+    ret += dict;
+
+    return ret;
+}
+
+// The size of a header with room for any shape with the given number of
+// dimensions, so the shape can be updated in place as data is written.
+static inline size_t getGrowableNpyHeaderSize(
+    const std::string& descr,
+    const bool fortranOrder,
+    const size_t numDims)
+{
+    const std::vector<size_t> shape(numDims, 0);
+    const auto dict = detail::makeNpyDict(descr, fortranOrder, detail::formatNpyShape(shape));
+
+    return detail::getNpyHeaderSize(dict.size() + (numDims * (detail::NpyMaxDimDigits - 1)));
+}
+
+// The native sinks write a single channel as a 1D array, and multiple
+// channels as a Fortran-order (nchans, N) array, with each sample's channels
+// stored together.
+static inline std::string makeChannelsNpyHeader(
+    const std::string& descr,
+    const size_t numChannels,
+    const size_t numElements,
+    const size_t minSize = 0)
+{
+    if(1 == numChannels) return makeNpyHeader(descr, false, {numElements}, minSize);
+    else                 return makeNpyHeader(descr, true, {numChannels, numElements}, minSize);
+}
+
+static inline size_t getGrowableChannelsNpyHeaderSize(
+    const std::string& descr,
+    const size_t numChannels)
+{
+    return getGrowableNpyHeaderSize(descr, (numChannels > 1), ((1 == numChannels) ? 1 : 2));
+}
+
+static inline NpyHeader readNpyHeader(
+    std::istream& stream,
+    const std::string& filepath)
+{
+    std::string magic(detail::NpyMagic.size(), '\0');
+    char version[2] = {0, 0};
+
+    stream.read(&magic[0], magic.size());
+    stream.read(version, sizeof(version));
+    if(!stream || (magic != detail::NpyMagic))
+    {
+        throw Pothos::DataFormatException("Not a .npy file", filepath);
+    }
+    if((version[0] < 1) || (version[0] > 3))
+    {
+        throw Pothos::DataFormatException("Unsupported .npy version "+std::to_string(int(version[0])), filepath);
+    }
+
+    const size_t lengthSize = (1 == version[0]) ? 2 : 4;
+    unsigned char lengthBytes[4] = {0, 0, 0, 0};
+    stream.read(reinterpret_cast<char*>(lengthBytes), lengthSize);
+
+    size_t dictSize = 0;
+    for(size_t byte = 0; byte < lengthSize; ++byte)
+    {
+        dictSize |= (size_t(lengthBytes[byte]) << (8*byte));
+    }
+
+    std::string dict(dictSize, '\0');
+    stream.read(&dict[0], dictSize);
+    if(!stream)
+    {
+        throw Pothos::DataFormatException("Truncated .npy header", filepath);
+    }
+
+    NpyHeader header;
+    header.dataOffset = detail::NpyMagic.size() + 2 + lengthSize + dictSize;
+
+    auto pos = detail::findNpyDictValue(dict, "descr");
+    const char quote = (pos < dict.size()) ? dict[pos] : '\0';
+    const auto descrEnd = ((quote == '\'') || (quote == '"')) ? dict.find(quote, pos+1) : std::string::npos;
+    if(std::string::npos == descrEnd)
+    {
+        throw Pothos::DataFormatException("Unsupported .npy type (structured arrays are not supported)", filepath);
+    }
+    header.descr = dict.substr(pos+1, descrEnd-pos-1);
+
+    pos = detail::findNpyDictValue(dict, "fortran_order");
+    if(0 == dict.compare(pos, 4, "True"))       header.fortranOrder = true;
+    else if(0 == dict.compare(pos, 5, "False")) header.fortranOrder = false;
+    else throw Pothos::DataFormatException("Invalid .npy header: invalid fortran_order", filepath);
+
+    pos = detail::findNpyDictValue(dict, "shape");
+    const auto shapeEnd = dict.find(')', pos);
+    if((pos >= dict.size()) || ('(' != dict[pos]) || (std::string::npos == shapeEnd))
+    {
+        throw Pothos::DataFormatException("Invalid .npy header: invalid shape", filepath);
+    }
+    header.shape = detail::parseNpyShape(dict.substr(pos+1, shapeEnd-pos-1));
+
+    return header;
+}
+
+//
+// Data layout
+//
+
+// Multiple channels are written as a Fortran-order array of shape (nchans, N),
+// where each sample's channels are stored together. This writes one channel's
+// elements to every numChannels'th element of the output.
+static inline void interleaveChannel(
+    const char* in,
+    char* out,
+    const size_t numElems,
+    const size_t numChannels,
+    const size_t elemSize)
+{
+    switch(elemSize)
+    {
+    case 1:
+        detail::interleaveChannel<1>(in, out, numElems, numChannels);
+        break;
+
+    case 2:
+        detail::interleaveChannel<2>(in, out, numElems, numChannels);
+        break;
+
+    case 4:
+        detail::interleaveChannel<4>(in, out, numElems, numChannels);
+        break;
+
+    case 8:
+        detail::interleaveChannel<8>(in, out, numElems, numChannels);
+        break;
+
+    case 16:
+        detail::interleaveChannel<16>(in, out, numElems, numChannels);
+        break;
+
+    default:
+        throw Pothos::AssertionViolationException("Invalid element size", std::to_string(elemSize));
+    }
+}
+
+// Interleaves every channel at once, into a Fortran-order (nchans, N) array.
+static inline void interleaveChannels(
+    const std::vector<const char*>& ins,
+    char* out,
+    const size_t numElems,
+    const size_t elemSize)
+{
+    for(size_t chan = 0; chan < ins.size(); ++chan)
+    {
+        interleaveChannel(ins[chan], out + (chan * elemSize), numElems, ins.size(), elemSize);
+    }
+}
+
+// Writes the channels as the next numElems samples of a Fortran-order
+// (nchans, N) array. A single channel is written as-is, and multiple
+// channels are interleaved into the given buffer first.
+template <typename Writer>
+static inline void writeChannels(
+    Writer& writer,
+    const std::vector<const char*>& channels,
+    const size_t numElems,
+    const size_t elemSize,
+    std::vector<char>& interleaveBuffer)
+{
+    if(1 == channels.size())
+    {
+        writer.write(channels[0], numElems * elemSize);
+    }
+    else
+    {
+        interleaveBuffer.resize(numElems * channels.size() * elemSize);
+        interleaveChannels(channels, interleaveBuffer.data(), numElems, elemSize);
+        writer.write(interleaveBuffer.data(), interleaveBuffer.size());
+    }
+}
+
+// The inverse of interleaveChannel, for every channel at once: splits a
+// Fortran-order (nchans, N) array into one contiguous output per channel.
+static inline void deinterleaveChannels(
+    const char* in,
+    const std::vector<char*>& outs,
+    const size_t numElems,
+    const size_t elemSize)
+{
+    switch(elemSize)
+    {
+    case 1:
+        detail::deinterleaveChannels<1>(in, outs.data(), numElems, outs.size());
+        break;
+
+    case 2:
+        detail::deinterleaveChannels<2>(in, outs.data(), numElems, outs.size());
+        break;
+
+    case 4:
+        detail::deinterleaveChannels<4>(in, outs.data(), numElems, outs.size());
+        break;
+
+    case 8:
+        detail::deinterleaveChannels<8>(in, outs.data(), numElems, outs.size());
+        break;
+
+    case 16:
+        detail::deinterleaveChannels<16>(in, outs.data(), numElems, outs.size());
+        break;
+
+    default:
+        throw Pothos::AssertionViolationException("Invalid element size", std::to_string(elemSize));
+    }
+}
+
+// For big-endian files, swaps the bytes of each word in place. Complex
+// values are swapped one component at a time.
+static inline void byteswapWords(
+    char* data,
+    const size_t size,
+    const size_t wordSize)
+{
+    for(size_t pos = 0; (pos + wordSize) <= size; pos += wordSize)
+    {
+        std::reverse(data + pos, data + pos + wordSize);
+    }
+}
+
+}
@@ -0,0 +1,337 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/MappedArray.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/Glob.h>
+
+#include <algorithm>
+#include <future>
+#include <set>
+#include <string>
+#include <vector>
+
+//
+// Plays a series of .npy files back to back, each straight out of a memory
+// mapping, like /numpy/npy_source. While one file plays, the next is mapped
+// and its first pages are read in on a background thread, so switching
+// files doesn't wait on the disk.
+//
+
+class NpyPlaylistSource: public PothosNumPy::BaseBlock
+{
+    public:
+        NpyPlaylistSource(
+            const std::vector<std::string>& filepaths,
+            const bool repeat
+        ):
+            PothosNumPy::BaseBlock("/numpy/npy_playlist_source"),
+            _filepaths(expandFilepaths(filepaths)),
+            _repeat(repeat),
+            _prefetchMB(64.0),
+            _numChannels(0),
+            _fileIndex(0),
+            _pos(0),
+            _passElements(0)
+        {
+            if(_filepaths.empty())
+            {
+                throw Pothos::InvalidArgumentException("No files were given.");
+            }
+
+            // Mapping a file doesn't read it, so this only reads each header.
+            // Files are mapped again when they're played.
+            const auto firstArray = PothosNumPy::MappedArray::fromNpyFile(_filepaths[0]);
+            _dtype = firstArray.dtype();
+            _numChannels = firstArray.numChannels();
+
+            for(size_t index = 1; index < _filepaths.size(); ++index)
+            {
+                this->checkArray(PothosNumPy::MappedArray::fromNpyFile(_filepaths[index]), _filepaths[index]);
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, filepaths));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, repeat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, setRepeat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, prefetchMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, setPrefetchMB));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, fileIndex));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyPlaylistSource, currentFilepath));
+            this->registerProbe("fileIndex");
+            this->registerProbe("currentFilepath");
+
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                this->setupOutput(chan, _dtype);
+            }
+        }
+
+        virtual ~NpyPlaylistSource() = default;
+
+        // With any patterns expanded
+        std::vector<std::string> filepaths() const
+        {
+            return _filepaths;
+        }
+
+        bool repeat() const
+        {
+            return _repeat;
+        }
+
+        void setRepeat(const bool repeat)
+        {
+            _repeat = repeat;
+        }
+
+        // How much of the next file to read in before it plays, per channel
+        double prefetchMB() const
+        {
+            return _prefetchMB;
+        }
+
+        void setPrefetchMB(const double prefetchMB)
+        {
+            if(prefetchMB < 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Prefetch size cannot be negative.");
+            }
+
+            _prefetchMB = prefetchMB;
+        }
+
+        size_t fileIndex() const
+        {
+            return _fileIndex;
+        }
+
+        std::string currentFilepath() const
+        {
+            return _filepaths[_fileIndex];
+        }
+
+        void activate() override
+        {
+            _fileIndex = 0;
+            _pos = 0;
+            _passElements = 0;
+
+            _array = PothosNumPy::MappedArray::fromNpyFile(_filepaths[0]);
+            this->checkArray(_array, _filepaths[0]);
+
+            this->prefetchNextFile();
+        }
+
+        void deactivate() override
+        {
+            // The prefetched file is discarded, along with any error.
+            if(_nextArray.valid()) _nextArray.wait();
+            _nextArray = std::future<PothosNumPy::MappedArray>();
+
+            _array = PothosNumPy::MappedArray();
+        }
+
+        void work() override
+        {
+            if(!this->nextFile()) return;
+
+            const auto elems = std::min(
+                this->workInfo().minAllOutElements,
+                _array.numElements() - _pos);
+            if(!this->countWork(elems)) return;
+
+            if(_array.canPostInPlace())
+            {
+                _array.postChannels(this->outputs(), _pos, elems);
+            }
+            else
+            {
+                this->timeCopy([&](){_array.copyChannels(this->outputs(), _pos, elems);});
+                for(auto* output: this->outputs()) output->produce(elems);
+            }
+
+            _pos += elems;
+            _passElements += elems;
+            this->countElements(0, elems);
+        }
+
+    private:
+        std::vector<std::string> _filepaths;
+        bool _repeat;
+        double _prefetchMB;
+
+        Pothos::DType _dtype;
+        size_t _numChannels;
+
+        PothosNumPy::MappedArray _array;
+        size_t _fileIndex;
+        size_t _pos;
+
+        // The file after _fileIndex, mapped and prefetched in the background
+        std::future<PothosNumPy::MappedArray> _nextArray;
+
+        // Samples output since the start of the playlist, so a playlist of
+        // empty files isn't repeated forever
+        size_t _passElements;
+
+        // Entries with wildcards are replaced by the files they match, in
+        // sorted order.
+        static std::vector<std::string> expandFilepaths(const std::vector<std::string>& filepaths)
+        {
+            std::vector<std::string> expandedFilepaths;
+            for(const auto& filepath: filepaths)
+            {
+                if(std::string::npos == filepath.find_first_of("*?["))
+                {
+                    expandedFilepaths.emplace_back(filepath);
+                    continue;
+                }
+
+                std::set<std::string> matches;
+                Poco::Glob::glob(filepath, matches);
+                if(matches.empty())
+                {
+                    throw Pothos::FileNotFoundException("No files match the given pattern", filepath);
+                }
+
+                expandedFilepaths.insert(expandedFilepaths.end(), matches.begin(), matches.end());
+            }
+
+            return expandedFilepaths;
+        }
+
+        void checkArray(const PothosNumPy::MappedArray& array, const std::string& filepath) const
+        {
+            if(array.dtype() != _dtype)
+            {
+                throw Pothos::DataFormatException(
+                          "Mismatched dtypes: "+_dtype.name()+" vs "+array.dtype().name(),
+                          filepath);
+            }
+            if(array.numChannels() != _numChannels)
+            {
+                throw Pothos::DataFormatException(
+                          "Mismatched # channels: "+std::to_string(_numChannels)+" vs "+std::to_string(array.numChannels()),
+                          filepath);
+            }
+        }
+
+        // The file after the current one, or the number of files at the end
+        // of the playlist
+        size_t nextFileIndex() const
+        {
+            const auto nextIndex = _fileIndex + 1;
+            if(nextIndex < _filepaths.size()) return nextIndex;
+
+            return _repeat ? 0 : _filepaths.size();
+        }
+
+        void prefetchNextFile()
+        {
+            const auto nextIndex = this->nextFileIndex();
+            if((nextIndex == _filepaths.size()) || (nextIndex == _fileIndex)) return;
+
+            const auto filepath = _filepaths[nextIndex];
+            const auto prefetchSize = size_t(_prefetchMB * (1 << 20));
+            _nextArray = std::async(std::launch::async, [filepath, prefetchSize]()
+            {
+                auto array = PothosNumPy::MappedArray::fromNpyFile(filepath);
+                array.prefault(prefetchSize);
+
+                return array;
+            });
+        }
+
+        // Move past the end of the current file, skipping empty files.
+        // Returns false at the end of the playlist.
+        bool nextFile()
+        {
+            while(_pos == _array.numElements())
+            {
+                const auto nextIndex = this->nextFileIndex();
+                if(nextIndex == _filepaths.size()) return false;
+
+                if(0 == nextIndex)
+                {
+                    if(0 == _passElements) return false;
+                    _passElements = 0;
+                }
+
+                // A single-file playlist just starts over.
+                if(nextIndex != _fileIndex)
+                {
+                    // If repeat was turned on at the end of the playlist,
+                    // the first file wasn't prefetched.
+                    if(!_nextArray.valid()) this->prefetchNextFile();
+
+                    // Time spent waiting on the prefetch
+                    this->timeFunc([&](){_array = _nextArray.get();});
+                    this->checkArray(_array, _filepaths[nextIndex]);
+                }
+
+                _fileIndex = nextIndex;
+                _pos = 0;
+                this->prefetchNextFile();
+            }
+
+            return true;
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc .npy Playlist Source
+ *
+ * Corresponding NumPy function: <b>numpy.load</b> (with .npy extension)
+ *
+ * Plays a list of .npy files back to back as one continuous stream, such
+ * as the segments written by the .npy File Sink's segmented mode. Entries
+ * can include wildcards, such as <b>"/captures/capture_*.npy"</b>, which
+ * are replaced by every matching file in sorted order. Every file must have
+ * the same type and number of channels.
+ *
+ * Like the .npy File Source, each file is memory-mapped, and the output
+ * buffers point directly into the mapping, so samples are not copied unless
+ * the file is big-endian or a Fortran-order 2D array.
+ *
+ * While a file plays, the next one is opened on a background thread, and
+ * the first <b>prefetchMB</b> of each of its channels are read into memory,
+ * so there is no gap or slowdown when playback reaches it.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sources/NumPy
+ * |keywords load numpy binary file IO mmap playlist glob segments
+ * |factory /numpy/npy_playlist_source(filepaths,repeat)
+ * |setter setRepeat(repeat)
+ * |setter setPrefetchMB(prefetchMB)
+ *
+ * |param filepaths[Filepaths] A list of .npy files or patterns.
+ * |widget StringEntry()
+ * |default ["/tmp/capture_*.npy"]
+ * |preview enable
+ *
+ * |param repeat[Repeat?] Start over from the first file after the last one.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ *
+ * |param prefetchMB[Prefetch] How much of the next file to read ahead of time, per channel.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeNpyPlaylistSource(
+    const std::vector<std::string>& filepaths,
+    const bool repeat)
+{
+    return new NpyPlaylistSource(filepaths, repeat);
+}
+
+static Pothos::BlockRegistry registerNumPyNpyPlaylistSource(
+    "/numpy/npy_playlist_source",
+    Pothos::Callable(&makeNpyPlaylistSource));
@@ -0,0 +1,593 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/FileSinkBlock.hpp"
+#include "Cpp/NpyFormat.hpp"
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/Path.h>
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// Level triggering
+//
+
+namespace detail
+{
+    template <typename T>
+    static inline double squaredMagnitude(const T& value)
+    {
+        return double(value) * double(value);
+    }
+
+    template <typename T>
+    static inline double squaredMagnitude(const std::complex<T>& value)
+    {
+        return double(std::norm(value));
+    }
+
+    // Returns the index of the first sample whose magnitude rises to at
+    // least the level, or numElems if there isn't one. aboveLevel is whether
+    // the previous sample was, and is updated to the last sample checked.
+    template <typename T>
+    static size_t findLevelCrossing(
+        const void* in,
+        const size_t numElems,
+        const double level,
+        char& aboveLevel)
+    {
+        const auto* samples = reinterpret_cast<const T*>(in);
+        const double squaredLevel = level * level;
+
+        for(size_t elem = 0; elem < numElems; ++elem)
+        {
+            const bool above = (squaredMagnitude(samples[elem]) >= squaredLevel);
+            if(above && !aboveLevel)
+            {
+                aboveLevel = true;
+                return elem;
+            }
+
+            aboveLevel = above;
+        }
+
+        return numElems;
+    }
+
+    struct LevelCrossingFcnGetter
+    {
+        using Fcn = size_t(*)(const void*, const size_t, const double, char&);
+
+        template <typename T>
+        static Fcn get()
+        {
+            return &findLevelCrossing<T>;
+        }
+    };
+}
+
+using LevelCrossingFcn = detail::LevelCrossingFcnGetter::Fcn;
+
+static LevelCrossingFcn getLevelCrossingFcn(const Pothos::DType& dtype)
+{
+    auto fcn = PothosNumPy::getRealDTypeFcn<detail::LevelCrossingFcnGetter>(dtype);
+    if(!fcn) fcn = PothosNumPy::getComplexDTypeFcn<detail::LevelCrossingFcnGetter>(dtype);
+    if(!fcn) throw Pothos::InvalidArgumentException("Unsupported trigger type", dtype.name());
+
+    return fcn;
+}
+
+//
+// Keeps the last preTrigger samples of each channel in memory, and only
+// writes to disk when a trigger fires, so disk usage scales with the event
+// rate instead of the sample rate. Each capture is the samples before the
+// trigger, followed by postTrigger samples starting at the trigger.
+//
+// The history is kept per channel, so it's a plain copy as samples arrive.
+// Multiple channels are only interleaved into Fortran order, like
+// /numpy/npy_sink, when a capture is written. Captures are written and
+// finished the same way as the .npy sink's segments.
+//
+
+class NpyTriggerSink: public PothosNumPy::FileSinkBlock
+{
+    public:
+        NpyTriggerSink(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const size_t nchans,
+            const size_t preTrigger,
+            const size_t postTrigger
+        ):
+            PothosNumPy::FileSinkBlock("/numpy/npy_trigger_sink"),
+            _filepath(filepath),
+            _descr(PothosNumPy::dtypeToNpyDescr(dtype)),
+            _elemSize(dtype.elemSize()),
+            _numChannels(nchans),
+            _preTrigger(preTrigger),
+            _postTrigger(0),
+            _triggerLevel(0.0),
+            _captureNaming("numbered"),
+            _levelCrossingFcn(getLevelCrossingFcn(dtype)),
+            _aboveLevel(nchans, false),
+            _historyPos(0),
+            _historySize(0),
+            _dataOffset(0),
+            _numElements(0),
+            _postRemaining(0),
+            _captureIndex(0)
+        {
+            if(Poco::Path(filepath).getExtension() != "npy")
+            {
+                throw Pothos::InvalidArgumentException("Only .npy files are supported.", filepath);
+            }
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+
+            this->setPostTrigger(postTrigger);
+
+            _history.resize(_numChannels * _preTrigger * _elemSize);
+            _dataOffset = PothosNumPy::getGrowableChannelsNpyHeaderSize(_descr, _numChannels);
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, preTrigger));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, postTrigger));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, setPostTrigger));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, triggerLabel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, setTriggerLabel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, triggerLevel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, setTriggerLevel));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, captureNaming));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, setCaptureNaming));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, numCaptures));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpyTriggerSink, lastCapturePath));
+            this->registerProbe("numCaptures");
+            this->registerProbe("lastCapturePath");
+            this->setupSeriesSignal("captureFinished");
+
+            for(size_t chan = 0; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, dtype);
+            }
+        }
+
+        virtual ~NpyTriggerSink() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        size_t preTrigger() const
+        {
+            return _preTrigger;
+        }
+
+        // Takes effect at the next trigger
+        size_t postTrigger() const
+        {
+            return _postTrigger;
+        }
+
+        void setPostTrigger(const size_t postTrigger)
+        {
+            if(0 == postTrigger)
+            {
+                throw Pothos::InvalidArgumentException("Post-trigger length must be positive.");
+            }
+
+            _postTrigger = postTrigger;
+        }
+
+        // An empty label disables triggering on labels.
+        std::string triggerLabel() const
+        {
+            return _triggerLabel;
+        }
+
+        void setTriggerLabel(const std::string& triggerLabel)
+        {
+            _triggerLabel = triggerLabel;
+        }
+
+        // 0 disables triggering on levels.
+        double triggerLevel() const
+        {
+            return _triggerLevel;
+        }
+
+        void setTriggerLevel(const double triggerLevel)
+        {
+            if(triggerLevel < 0.0)
+            {
+                throw Pothos::InvalidArgumentException("Trigger level cannot be negative.");
+            }
+
+            _triggerLevel = triggerLevel;
+        }
+
+        std::string captureNaming() const
+        {
+            return _captureNaming;
+        }
+
+        void setCaptureNaming(const std::string& captureNaming)
+        {
+            PothosNumPy::checkSeriesNaming(captureNaming);
+            _captureNaming = captureNaming;
+        }
+
+        // Captures finished since the block was last activated
+        size_t numCaptures() const
+        {
+            return this->numSeriesFiles();
+        }
+
+        std::string lastCapturePath() const
+        {
+            return this->lastSeriesFilePath();
+        }
+
+        void activate() override
+        {
+            _historyPos = 0;
+            _historySize = 0;
+            std::fill(_aboveLevel.begin(), _aboveLevel.end(), false);
+
+            _captureIndex = 0;
+            this->resetSeries();
+        }
+
+        void deactivate() override
+        {
+            // A capture cut short by the end of the stream is kept.
+            if(_file) this->finishCapture();
+            this->waitForSeriesFile();
+        }
+
+        void work() override
+        {
+            this->waitForSeriesFile(false);
+
+            const auto elems = this->workInfo().minAllInElements;
+            if(!this->countWork(elems)) return;
+
+            this->timeFunc([&]()
+            {
+                size_t pos = 0;
+                while(pos < elems)
+                {
+                    if(!_file)
+                    {
+                        const auto triggerIndex = this->findTrigger(pos, elems);
+                        this->pushHistory(pos, triggerIndex - pos);
+
+                        pos = triggerIndex;
+                        if(pos < elems) this->startCapture();
+                    }
+                    else
+                    {
+                        const auto captureElems = std::min(elems - pos, _postRemaining);
+                        this->writeSamples(this->inputPointers(pos), captureElems);
+                        this->pushHistory(pos, captureElems);
+                        this->resetLevelState(pos + captureElems - 1);
+
+                        pos += captureElems;
+                        _postRemaining -= captureElems;
+                        if(0 == _postRemaining) this->finishCapture();
+                    }
+                }
+            });
+
+            for(auto* input: this->inputs()) input->consume(elems);
+            this->countElements(elems, 0);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _descr;
+        size_t _elemSize;
+        size_t _numChannels;
+
+        size_t _preTrigger;
+        size_t _postTrigger;
+        std::string _triggerLabel;
+        double _triggerLevel;
+        std::string _captureNaming;
+
+        // Whether each channel's last sample was at or above the level
+        LevelCrossingFcn _levelCrossingFcn;
+        std::vector<char> _aboveLevel;
+
+        // Each channel's last _preTrigger samples, stored one channel after
+        // another. _historyPos is where the next sample goes.
+        std::vector<char> _history;
+        size_t _historyPos;
+        size_t _historySize;
+
+        std::vector<char> _interleaveBuffer;
+        std::unique_ptr<PothosNumPy::AsyncFileWriter> _file;
+
+        // The capture in progress, if _file is set
+        std::string _capturePath;
+        size_t _dataOffset;
+        size_t _numElements;
+        size_t _postRemaining;
+        size_t _captureIndex;
+
+        const PothosNumPy::AsyncFileWriter* fileWriter() const override
+        {
+            return _file.get();
+        }
+
+        // The first index in [minIndex, maxIndex) that triggers a capture,
+        // or maxIndex if there isn't one
+        size_t findTrigger(const size_t minIndex, const size_t maxIndex)
+        {
+            auto triggerIndex = maxIndex;
+            if(!_triggerLabel.empty())
+            {
+                for(const auto* input: this->inputs())
+                {
+                    for(const auto& label: input->labels())
+                    {
+                        if((label.id == _triggerLabel) && (label.index >= minIndex))
+                        {
+                            triggerIndex = std::min(triggerIndex, size_t(label.index));
+                        }
+                    }
+                }
+            }
+
+            // Only the samples before any earlier trigger are checked. A
+            // channel checked past the final trigger index is fixed up
+            // once the capture starting there is written.
+            if(_triggerLevel > 0.0)
+            {
+                const auto& inputs = this->inputs();
+                for(size_t chan = 0; chan < _numChannels; ++chan)
+                {
+                    triggerIndex = minIndex + _levelCrossingFcn(
+                                       inputs[chan]->buffer().as<const char*>() + (minIndex * _elemSize),
+                                       triggerIndex - minIndex,
+                                       _triggerLevel,
+                                       _aboveLevel[chan]);
+                }
+            }
+
+            return triggerIndex;
+        }
+
+        // Sets each channel's level state from the given sample, so a
+        // trigger can only fire after a capture ends on a new crossing.
+        void resetLevelState(const size_t index)
+        {
+            if(_triggerLevel <= 0.0) return;
+
+            // Starting from above the level, a single sample can't cross it,
+            // so this just checks the sample.
+            const auto& inputs = this->inputs();
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                _aboveLevel[chan] = true;
+                (void)_levelCrossingFcn(
+                    inputs[chan]->buffer().as<const char*>() + (index * _elemSize),
+                    1,
+                    _triggerLevel,
+                    _aboveLevel[chan]);
+            }
+        }
+
+        std::vector<const char*> inputPointers(const size_t index) const
+        {
+            std::vector<const char*> pointers;
+            for(const auto* input: this->inputs())
+            {
+                pointers.emplace_back(input->buffer().as<const char*>() + (index * _elemSize));
+            }
+
+            return pointers;
+        }
+
+        void pushHistory(size_t index, size_t elems)
+        {
+            if(0 == _preTrigger) return;
+
+            // Only the newest samples are kept.
+            if(elems > _preTrigger)
+            {
+                index += elems - _preTrigger;
+                elems = _preTrigger;
+            }
+
+            const auto firstElems = std::min(elems, _preTrigger - _historyPos);
+            const auto inputs = this->inputPointers(index);
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                auto* channelHistory = _history.data() + (chan * _preTrigger * _elemSize);
+                std::memcpy(channelHistory + (_historyPos * _elemSize), inputs[chan], firstElems * _elemSize);
+                std::memcpy(channelHistory, inputs[chan] + (firstElems * _elemSize), (elems - firstElems) * _elemSize);
+            }
+
+            _historyPos = (_historyPos + elems) % _preTrigger;
+            _historySize = std::min(_historySize + elems, _preTrigger);
+        }
+
+        // Writes the history, oldest first, which wraps around at most once.
+        void writeHistory()
+        {
+            if(0 == _historySize) return;
+
+            const auto oldest = (_historyPos + _preTrigger - _historySize) % _preTrigger;
+            const auto firstElems = std::min(_historySize, _preTrigger - oldest);
+
+            std::vector<const char*> pointers;
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                pointers.emplace_back(_history.data() + (((chan * _preTrigger) + oldest) * _elemSize));
+            }
+            this->writeSamples(pointers, firstElems);
+
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                pointers[chan] = _history.data() + (chan * _preTrigger * _elemSize);
+            }
+            this->writeSamples(pointers, _historySize - firstElems);
+        }
+
+        void writeSamples(const std::vector<const char*>& channels, const size_t elems)
+        {
+            if(0 == elems) return;
+
+            PothosNumPy::writeChannels(*_file, channels, elems, _elemSize, _interleaveBuffer);
+
+            _numElements += elems;
+        }
+
+        void startCapture()
+        {
+            _capturePath = PothosNumPy::makeSeriesFilepath(_filepath, _captureNaming, _captureIndex);
+            _numElements = 0;
+            _postRemaining = _postTrigger;
+
+            _file.reset(new PothosNumPy::AsyncFileWriter(
+                _capturePath + ".part",
+                true,
+                this->fileSyncMode(),
+                this->fileSyncInterval()));
+            _file->write(PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset).data(), _dataOffset);
+
+            this->writeHistory();
+        }
+
+        // New files always have room for the shape, so the header is
+        // rewritten in place.
+        void finishCapture()
+        {
+            const auto header = PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _dataOffset);
+            _file->writeAt(0, header.data(), header.size());
+
+            this->finishSeriesFile(std::move(_file), _capturePath);
+            ++_captureIndex;
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc .npy Trigger Sink
+ *
+ * Corresponding NumPy function: <b>numpy.save</b>
+ *
+ * Keeps the last <b>preTrigger</b> samples of each channel in memory, and
+ * when a trigger fires, writes them to a new file, followed by
+ * <b>postTrigger</b> samples starting at the trigger. Nothing is written
+ * between triggers, so disk bandwidth and storage scale with how often
+ * events occur rather than the sample rate.
+ *
+ * A trigger fires at each sample with the label <b>triggerLabel</b> on any
+ * input, such as the MAX or MIN labels posted by the NumPy statistics
+ * blocks, and when the magnitude of any channel rises to at least
+ * <b>triggerLevel</b>. Triggers during a capture are ignored. A capture may
+ * have fewer pre-trigger samples if it starts soon after the stream or the
+ * previous capture, and may be cut short when the topology stops.
+ *
+ * Captures are named after the filepath, with either a sequence number or
+ * the UTC time of the trigger, as in <b>capture_000000.npy</b> or
+ * <b>capture_20230102T030405.678901Z.npy</b>, and have a <b>.part</b>
+ * suffix until they're finished. Each finished capture's path is emitted
+ * by the <b>captureFinished</b> signal. A single channel is written as a
+ * 1D array, and multiple channels as a Fortran-order 2D array with one row
+ * per channel, like the .npy File Sink.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sinks/NumPy
+ * |keywords save numpy binary file IO trigger event capture ring buffer
+ * |factory /numpy/npy_trigger_sink(filepath,dtype,nchans,preTrigger,postTrigger)
+ * |setter setSyncMode(syncMode)
+ * |setter setSyncIntervalMB(syncIntervalMB)
+ * |setter setTriggerLabel(triggerLabel)
+ * |setter setTriggerLevel(triggerLevel)
+ * |setter setCaptureNaming(captureNaming)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Channels] The number of inputs.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param preTrigger[Pre-Trigger] The number of samples per channel to keep from before each trigger.
+ * |widget SpinBox(minimum=0)
+ * |default 1024
+ * |preview enable
+ *
+ * |param postTrigger[Post-Trigger] The number of samples per channel to write starting at each trigger.
+ * |widget SpinBox(minimum=1)
+ * |default 4096
+ * |preview enable
+ *
+ * |param triggerLabel[Trigger Label] Trigger at each sample with this label. Empty disables this.
+ * |widget StringEntry()
+ * |default ""
+ * |preview enable
+ *
+ * |param triggerLevel[Trigger Level] Trigger when a sample's magnitude rises to at least this. 0 disables this.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |preview enable
+ *
+ * |param captureNaming[Capture Naming] How capture filenames are made unique.
+ * |option [Numbered] "numbered"
+ * |option [Timestamp] "timestamp"
+ * |widget ComboBox(editable=false)
+ * |default "numbered"
+ * |preview disable
+ *
+ * |param syncMode[Sync Mode] When each capture is flushed to disk. Only that file is synced, not the whole filesystem.
+ * |option [Never] "never"
+ * |option [On Close] "close"
+ * |option [Every N MB] "interval"
+ * |widget ComboBox(editable=false)
+ * |default "close"
+ * |preview disable
+ *
+ * |param syncIntervalMB[Sync Interval] How much is written between syncs in the "Every N MB" mode.
+ * |widget DoubleSpinBox(minimum=1)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeNpyTriggerSink(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const size_t nchans,
+    const size_t preTrigger,
+    const size_t postTrigger)
+{
+    return new NpyTriggerSink(filepath, dtype, nchans, preTrigger, postTrigger);
+}
+
+static Pothos::BlockRegistry registerNumPyNpyTriggerSink(
+    "/numpy/npy_trigger_sink",
+    Pothos::Callable(&makeNpyTriggerSink));
@@ -0,0 +1,416 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/FileSinkBlock.hpp"
+#include "Cpp/NpyFormat.hpp"
+#include "Cpp/ZipArchive.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Streams samples into a new entry at the end of the archive as they arrive.
+// The other entries are left where they are, and the archive's central
+// directory is rewritten after the new entry when the block is deactivated,
+// so adding a key doesn't depend on the size of the rest of the archive.
+//
+// As with /numpy/npy_sink, the entry's .npy header has room for any shape
+// and is filled in at the end, and multiple channels are written as a
+// Fortran-order 2D array.
+//
+
+class NpzFileSink: public PothosNumPy::FileSinkBlock
+{
+    public:
+        // How much of an existing entry is held in memory at once when
+        // appending to it
+        static constexpr size_t CopyBufferSize = 1 << 20;
+
+        NpzFileSink(
+            const std::string& filepath,
+            const std::string& key,
+            const Pothos::DType& dtype,
+            const size_t nchans,
+            const bool compressed,
+            const bool append
+        ):
+            PothosNumPy::FileSinkBlock("/numpy/npz_sink"),
+            _filepath(filepath),
+            _key(key),
+            _descr(PothosNumPy::dtypeToNpyDescr(dtype)),
+            _elemSize(dtype.elemSize()),
+            _compressed(compressed),
+            _append(append),
+            _numChannels(nchans),
+            _headerSize(0),
+            _numElements(0)
+        {
+            if(Poco::Path(filepath).getExtension() != "npz")
+            {
+                throw Pothos::InvalidArgumentException("Only .npz files are supported.", filepath);
+            }
+            if(key.empty())
+            {
+                throw Pothos::InvalidArgumentException("Key must not be empty.");
+            }
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+
+            if(Poco::File(filepath).exists())
+            {
+                std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+                if(!stream)
+                {
+                    throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+                }
+
+                const auto directory = PothosNumPy::readZipDirectory(stream, filepath);
+                for(const auto& entry: directory.entries)
+                {
+                    _allKeys.emplace_back(entryNameToKey(entry.name));
+
+                    // If we're appending, make sure what's there matches our
+                    // given DType and number of channels.
+                    if(_append && (entry.name == this->entryName()))
+                    {
+                        PothosNumPy::ZipEntryStreamBuf existingData(filepath, entry);
+                        this->readExistingHeader(existingData);
+                    }
+                }
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSink, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSink, key));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSink, compressed));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSink, append));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSink, allKeys));
+
+            for(size_t chan = 0; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, dtype);
+            }
+        }
+
+        virtual ~NpzFileSink() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        std::string key() const
+        {
+            return _key;
+        }
+
+        bool compressed() const
+        {
+            return _compressed;
+        }
+
+        bool append() const
+        {
+            return _append;
+        }
+
+        // The keys in the file when the block was created
+        std::vector<std::string> allKeys() const
+        {
+            return _allKeys;
+        }
+
+        void activate() override
+        {
+            _writer.reset(new PothosNumPy::ZipArchiveWriter(
+                _filepath,
+                this->fileSyncMode(),
+                this->fileSyncInterval()));
+            _headerSize = PothosNumPy::getGrowableChannelsNpyHeaderSize(_descr, _numChannels);
+            _numElements = 0;
+
+            // The existing entry is replaced, so when appending, its data is
+            // copied into the new entry first. Nothing else in the archive
+            // is read.
+            std::unique_ptr<PothosNumPy::ZipEntryStreamBuf> existingData;
+            PothosNumPy::ZipEntry existingEntry;
+            PothosNumPy::NpyHeader existingHeader;
+            if(_append)
+            {
+                const auto& entries = _writer->entries();
+                const auto entryIter = std::find_if(
+                    entries.begin(),
+                    entries.end(),
+                    [this](const PothosNumPy::ZipEntry& entry){return (entry.name == this->entryName());});
+
+                if(entries.end() != entryIter)
+                {
+                    // Validate again in case the file changed since construction.
+                    existingEntry = *entryIter;
+                    existingData.reset(new PothosNumPy::ZipEntryStreamBuf(_filepath, existingEntry));
+                    existingHeader = this->readExistingHeader(*existingData);
+                }
+            }
+
+            _writer->beginEntry(this->entryName(), _compressed, _headerSize);
+            if(existingData) this->copyExistingData(*existingData, existingEntry, existingHeader);
+        }
+
+        void deactivate() override
+        {
+            const auto header = PothosNumPy::makeChannelsNpyHeader(_descr, _numChannels, _numElements, _headerSize);
+
+            _writer->endEntry(header);
+            _writer->close();
+        }
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllInElements;
+            if(!this->countWork(elems)) return;
+
+            const auto& inputs = this->inputs();
+            this->timeFunc([&]()
+            {
+                std::vector<const char*> channels;
+                for(auto* input: inputs) channels.emplace_back(input->buffer().as<const char*>());
+
+                PothosNumPy::writeChannels(*_writer, channels, elems, _elemSize, _interleaveBuffer);
+            });
+
+            for(auto* input: inputs) input->consume(elems);
+            _numElements += elems;
+            this->countElements(elems, 0);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _key;
+        std::string _descr;
+        size_t _elemSize;
+        bool _compressed;
+        bool _append;
+        size_t _numChannels;
+        std::vector<std::string> _allKeys;
+
+        size_t _headerSize;
+
+        // Per channel
+        size_t _numElements;
+
+        std::unique_ptr<PothosNumPy::ZipArchiveWriter> _writer;
+        std::vector<char> _interleaveBuffer;
+
+        const PothosNumPy::AsyncFileWriter* fileWriter() const override
+        {
+            return _writer ? &_writer->file() : nullptr;
+        }
+
+        // numpy.savez stores each key as a .npy file, and numpy.load removes
+        // the extension.
+        static std::string entryNameToKey(const std::string& entryName)
+        {
+            static const std::string Extension(".npy");
+
+            const bool hasExtension = (entryName.size() > Extension.size()) &&
+                                      (0 == entryName.compare(entryName.size() - Extension.size(), Extension.size(), Extension));
+
+            return hasExtension ? entryName.substr(0, entryName.size() - Extension.size()) : entryName;
+        }
+
+        std::string entryName() const
+        {
+            return _key + ".npy";
+        }
+
+        PothosNumPy::NpyHeader readExistingHeader(PothosNumPy::ZipEntryStreamBuf& existingData) const
+        {
+            std::istream stream(&existingData);
+            const auto header = PothosNumPy::readNpyHeader(stream, _filepath);
+
+            const size_t expectedDims = (1 == _numChannels) ? 1 : 2;
+            if((expectedDims != header.shape.size()) || ((2 == expectedDims) && (_numChannels != header.shape[0])))
+            {
+                throw Pothos::InvalidArgumentException(
+                          "Mismatched # channels: "+std::to_string(_numChannels)+" vs "+PothosNumPy::detail::formatNpyShape(header.shape));
+            }
+            if(header.descr != _descr)
+            {
+                throw Pothos::InvalidArgumentException("Mismatched dtypes: "+_descr+" vs "+header.descr);
+            }
+
+            return header;
+        }
+
+        // Copy the data following the existing entry's header into the new
+        // entry, in pieces. Multi-channel arrays written by NumPy are in C
+        // order, with each channel stored contiguously, so each channel is
+        // read through its own stream to be interleaved.
+        void copyExistingData(
+            PothosNumPy::ZipEntryStreamBuf& existingData,
+            const PothosNumPy::ZipEntry& existingEntry,
+            const PothosNumPy::NpyHeader& header)
+        {
+            const size_t numElements = header.shape.back();
+            const size_t dataSize = _numChannels * numElements * _elemSize;
+
+            const auto readExisting = [&](PothosNumPy::ZipEntryStreamBuf& stream, char* data, const size_t size)
+            {
+                if(std::streamsize(size) != stream.sgetn(data, std::streamsize(size)))
+                {
+                    throw Pothos::DataFormatException("Truncated .npy data for key "+_key, _filepath);
+                }
+            };
+
+            if((1 == _numChannels) || header.fortranOrder)
+            {
+                std::vector<char> copyBuffer(std::min(dataSize, CopyBufferSize));
+                for(size_t pos = 0; pos < dataSize; pos += copyBuffer.size())
+                {
+                    const size_t size = std::min(copyBuffer.size(), dataSize - pos);
+
+                    readExisting(existingData, copyBuffer.data(), size);
+                    _writer->write(copyBuffer.data(), size);
+                }
+            }
+            else
+            {
+                // The given stream is already at the start of the first
+                // channel.
+                std::vector<std::unique_ptr<PothosNumPy::ZipEntryStreamBuf>> channelData;
+                for(size_t chan = 1; chan < _numChannels; ++chan)
+                {
+                    channelData.emplace_back(new PothosNumPy::ZipEntryStreamBuf(_filepath, existingEntry));
+                    channelData.back()->skip(header.dataOffset + (chan * numElements * _elemSize));
+                }
+
+                const size_t chunkElements = std::max<size_t>(1, CopyBufferSize / (_numChannels * _elemSize));
+                const size_t chunkSize = std::min(numElements, chunkElements) * _elemSize;
+
+                std::vector<char> channelBuffer(_numChannels * chunkSize);
+                std::vector<const char*> channels;
+                for(size_t chan = 0; chan < _numChannels; ++chan)
+                {
+                    channels.emplace_back(channelBuffer.data() + (chan * chunkSize));
+                }
+
+                for(size_t pos = 0; pos < numElements; pos += chunkElements)
+                {
+                    const size_t elems = std::min(chunkElements, numElements - pos);
+                    for(size_t chan = 0; chan < _numChannels; ++chan)
+                    {
+                        readExisting(
+                            (0 == chan) ? existingData : *channelData[chan-1],
+                            channelBuffer.data() + (chan * chunkSize),
+                            elems * _elemSize);
+                    }
+
+                    PothosNumPy::writeChannels(*_writer, channels, elems, _elemSize, _interleaveBuffer);
+                }
+            }
+
+            _numElements = numElements;
+        }
+};
+
+constexpr size_t NpzFileSink::CopyBufferSize;
+
+/***********************************************************************
+ * |PothosDoc .npz File Sink
+ *
+ * Corresponding NumPy functions: <b>numpy.savez</b>, <b>numpy.savez_compressed</b>
+ *
+ * Samples are streamed into a new entry at the end of the archive as they
+ * arrive, so memory use does not grow with the length of the capture, and
+ * the archive's other keys are neither loaded nor rewritten. If the key
+ * already exists, its old entry is no longer listed in the archive, but
+ * its space in the file is not reclaimed. When appending to an existing
+ * key, only that key's data is copied.
+ *
+ * When compressed, samples are compressed as they arrive, in chunks spread
+ * across one thread per core, so stopping the topology doesn't wait on
+ * compressing the whole capture.
+ *
+ * As with the .npy File Sink, the archive is written by a background
+ * thread, and the writeQueueDepth and writeBlockedSeconds probes show
+ * whether the disk is keeping up.
+ *
+ * Multiple channels are saved as a 2D array with one row per channel.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sinks
+ * |keywords save numpy binary file IO zip
+ * |factory /numpy/npz_sink(filepath,key,dtype,nchans,compressed,append)
+ * |setter setSyncMode(syncMode)
+ * |setter setSyncIntervalMB(syncIntervalMB)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param key[Key]
+ * |widget StringEntry()
+ * |default "key"
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Channels] The number of inputs.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param compressed[Compressed?]
+ * |default false
+ * |widget ToggleSwitch(on="True",off="False")
+ * |preview enable
+ *
+ * |param append[Append?]
+ * |default false
+ * |widget ToggleSwitch(on="True",off="False")
+ * |preview enable
+ *
+ * |param syncMode[Sync Mode] When the file is flushed to disk. Only this file is synced, not the whole filesystem.
+ * |option [Never] "never"
+ * |option [On Close] "close"
+ * |option [Every N MB] "interval"
+ * |widget ComboBox(editable=false)
+ * |default "close"
+ * |preview disable
+ *
+ * |param syncIntervalMB[Sync Interval] How much is written between syncs in the "Every N MB" mode.
+ * |widget DoubleSpinBox(minimum=1)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeNpzFileSink(
+    const std::string& filepath,
+    const std::string& key,
+    const Pothos::DType& dtype,
+    const size_t nchans,
+    const bool compressed,
+    const bool append)
+{
+    return new NpzFileSink(filepath, key, dtype, nchans, compressed, append);
+}
+
+static Pothos::BlockRegistry registerNumPyNpzSink(
+    "/numpy/npz_sink",
+    Pothos::Callable(&makeNpzFileSink));
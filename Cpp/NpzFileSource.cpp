@@ -0,0 +1,327 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/NpyFormat.hpp"
+#include "Cpp/WindowedSourceBlock.hpp"
+#include "Cpp/ZipArchive.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Decompresses the key's array as it's output, straight into the output
+// buffers, so memory use doesn't depend on the size of the array, and the
+// first samples are output without waiting for the rest. Only the ZIP
+// central directory and the key's .npy header are read on construction.
+//
+// C-order 2D arrays store each channel contiguously, so each channel is
+// read through its own decompressor. Fortran-order 2D arrays store each
+// sample's channels together, so they're read through one.
+//
+// Stored entries can be seeked to directly, but compressed entries must be
+// decompressed from the start of the entry up to the new position, so
+// seeking backwards or repeating a window that doesn't start at 0 costs
+// more for compressed archives.
+//
+
+class NpzFileSource: public PothosNumPy::WindowedSourceBlock
+{
+    public:
+        NpzFileSource(
+            const std::string& filepath,
+            const std::string& key,
+            const bool repeat
+        ):
+            PothosNumPy::WindowedSourceBlock("/numpy/npz_source", repeat),
+            _filepath(filepath),
+            _key(key),
+            _dataOffset(0),
+            _numChannels(0),
+            _streamPos(0),
+            _swapSize(0),
+            _isInterleaved(false)
+        {
+            if(!Poco::File(filepath).exists())
+            {
+                throw Pothos::FileNotFoundException("The given file does not exist", filepath);
+            }
+            if(Poco::Path(filepath).getExtension() != "npz")
+            {
+                throw Pothos::InvalidArgumentException("This block only accepts .npz files.", filepath);
+            }
+
+            PothosNumPy::ZipDirectory directory;
+            {
+                std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+                if(!stream)
+                {
+                    throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+                }
+
+                directory = PothosNumPy::readZipDirectory(stream, filepath);
+            }
+
+            // Match numpy.load, which lists keys without the .npy extension
+            // but accepts either.
+            static const std::string npyExtension = ".npy";
+            bool foundKey = false;
+            for(const auto& entry: directory.entries)
+            {
+                const bool isNpy = (entry.name.size() > npyExtension.size()) &&
+                                   (0 == entry.name.compare(entry.name.size() - npyExtension.size(), npyExtension.size(), npyExtension));
+                _allKeys.emplace_back(isNpy ? entry.name.substr(0, entry.name.size() - npyExtension.size()) : entry.name);
+
+                if(!foundKey && ((entry.name == key) || (entry.name == (key + npyExtension))))
+                {
+                    _entry = entry;
+                    foundKey = true;
+                }
+            }
+            if(!foundKey)
+            {
+                throw Pothos::InvalidArgumentException("Could not find key", key);
+            }
+
+            PothosNumPy::NpyHeader header;
+            {
+                PothosNumPy::ZipEntryStreamBuf entryData(filepath, _entry);
+                std::istream stream(&entryData);
+
+                header = PothosNumPy::readNpyHeader(stream, filepath);
+            }
+
+            if((1 != header.shape.size()) && (2 != header.shape.size()))
+            {
+                throw Pothos::DataFormatException("This block only supports 1D or 2D arrays.", filepath);
+            }
+
+            _dtype = PothosNumPy::npyDescrToDType(header.descr);
+            _dataOffset = header.dataOffset;
+            _numChannels = (1 == header.shape.size()) ? 1 : header.shape[0];
+            const size_t numElements = header.shape.back();
+            _isInterleaved = header.fortranOrder && (_numChannels > 1);
+            if(PothosNumPy::isNpyDescrByteSwapped(header.descr))
+            {
+                _swapSize = PothosNumPy::getByteSwapWordSize(_dtype);
+            }
+
+            if(_entry.uncompressedSize < (_dataOffset + (_numChannels * numElements * _dtype.elemSize())))
+            {
+                throw Pothos::DataFormatException("Entry is smaller than its header indicates: "+_entry.name, filepath);
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSource, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSource, key));
+            this->registerCall(this, POTHOS_FCN_TUPLE(NpzFileSource, allKeys));
+
+            this->setNumElements(numElements);
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                this->setupOutput(chan, _dtype);
+            }
+        }
+
+        virtual ~NpzFileSource() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        std::string key() const
+        {
+            return _key;
+        }
+
+        std::vector<std::string> allKeys() const
+        {
+            return _allKeys;
+        }
+
+        // The decompressors are only kept while the topology is running.
+        void deactivate() override
+        {
+            _streams.clear();
+            _interleaveBuffer = std::vector<char>();
+        }
+
+        void work() override
+        {
+            const auto elems = this->windowElements(this->workInfo().minAllOutElements);
+            if(!this->countWork(elems)) return;
+
+            const auto elemSize = _dtype.elemSize();
+
+            std::vector<char*> outs;
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                outs.emplace_back(this->output(chan)->buffer().as<char*>());
+            }
+
+            this->timeFunc([&]()
+            {
+                this->positionStreams();
+
+                if(_isInterleaved)
+                {
+                    _interleaveBuffer.resize(elems * _numChannels * elemSize);
+                    this->readStream(0, _interleaveBuffer.data(), _interleaveBuffer.size());
+                }
+                else
+                {
+                    for(size_t chan = 0; chan < _numChannels; ++chan)
+                    {
+                        this->readStream(chan, outs[chan], elems * elemSize);
+                    }
+                }
+            });
+
+            this->timeCopy([&]()
+            {
+                if(_isInterleaved)
+                {
+                    PothosNumPy::deinterleaveChannels(_interleaveBuffer.data(), outs, elems, elemSize);
+                }
+                if(_swapSize > 0)
+                {
+                    for(auto* out: outs) PothosNumPy::byteswapWords(out, elems * elemSize, _swapSize);
+                }
+            });
+
+            for(size_t chan = 0; chan < _numChannels; ++chan)
+            {
+                this->output(chan)->produce(elems);
+            }
+
+            this->advance(elems);
+            _streamPos = this->position();
+            this->countElements(0, elems);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _key;
+        std::vector<std::string> _allKeys;
+
+        PothosNumPy::ZipEntry _entry;
+        Pothos::DType _dtype;
+        size_t _dataOffset;
+
+        size_t _numChannels;
+
+        // One per channel, unless the channels are interleaved
+        std::vector<std::unique_ptr<PothosNumPy::ZipEntryStreamBuf>> _streams;
+
+        // The element the streams will read next
+        size_t _streamPos;
+
+        // Nonzero if each word of this many bytes must be byteswapped
+        size_t _swapSize;
+
+        // Fortran-order 2D arrays store the channels interleaved.
+        bool _isInterleaved;
+        std::vector<char> _interleaveBuffer;
+
+        // Move the streams to the current position, which only requires
+        // starting over if it's behind them.
+        void positionStreams()
+        {
+            const auto pos = this->position();
+            if(!_streams.empty() && (_streamPos == pos)) return;
+
+            const size_t streamElemSize = _dtype.elemSize() * (_isInterleaved ? _numChannels : 1);
+            if(_streams.empty() || (pos < _streamPos))
+            {
+                _streams.clear();
+
+                const size_t numStreams = _isInterleaved ? 1 : _numChannels;
+                for(size_t stream = 0; stream < numStreams; ++stream)
+                {
+                    _streams.emplace_back(new PothosNumPy::ZipEntryStreamBuf(_filepath, _entry));
+                    _streams.back()->skip(_dataOffset + (stream * this->numElements() * streamElemSize));
+                }
+                _streamPos = 0;
+            }
+
+            for(auto& stream: _streams) stream->skip((pos - _streamPos) * streamElemSize);
+            _streamPos = pos;
+        }
+
+        void readStream(const size_t stream, char* data, const size_t size)
+        {
+            if(std::streamsize(size) != _streams[stream]->sgetn(data, std::streamsize(size)))
+            {
+                throw Pothos::DataFormatException("Truncated ZIP entry "+_entry.name, _filepath);
+            }
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc .npz File Source
+ *
+ * Corresponding NumPy function: <b>numpy.load</b> (with .npz extension)
+ *
+ * The key's array is decompressed as it's output, so memory use stays
+ * the same regardless of the array's size, and playback starts without
+ * waiting for the whole array to be decompressed. Only the archive's
+ * directory is read to list its keys.
+ *
+ * Playback can be limited to <b>count</b> samples starting at
+ * <b>startIndex</b>, and repeat mode loops over just that window. The
+ * <b>seek</b> slot moves playback to any index within the window. In
+ * compressed archives, starting a window or seeking backwards means
+ * decompressing the array from the beginning up to that point.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sources/NumPy
+ * |keywords load numpy binary file IO zip
+ * |factory /numpy/npz_source(filepath,key,repeat)
+ * |setter setRepeat(repeat)
+ * |setter setStartIndex(startIndex)
+ * |setter setCount(count)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=open)
+ * |default ""
+ * |preview enable
+ *
+ * |param key[Key]
+ * |default ""
+ *
+ * |param repeat[Repeat?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ *
+ * |param startIndex[Start Index] The first sample to output, per channel.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param count[Count] The number of samples to output, per channel. 0 outputs everything after the start index.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ **********************************************************************/
+static Pothos::Block* makeNpzFileSource(
+    const std::string& filepath,
+    const std::string& key,
+    const bool repeat)
+{
+    return new NpzFileSource(filepath, key, repeat);
+}
+
+static Pothos::BlockRegistry registerNumPyNpzSource(
+    "/numpy/npz_source",
+    Pothos::Callable(&makeNpzFileSource));
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/Kernels.hpp"
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <string>
+#include <typeinfo>
+
+namespace PothosNumPy
+{
+
+//
+// Native equivalent of OneToOneBlock.py for stateless elementwise functions.
+// Func is a functor from ElementwiseFunctions.hpp, and results are written
+// directly into the output buffer.
+//
+
+template <typename Func>
+class OneToOneBlock: public BaseBlock
+{
+    public:
+        using InType = typename Func::InType;
+        using OutType = typename Func::OutType;
+
+        // Factory parameters: (dtype) or (inputDType, outputDType)
+        static Pothos::Block* make(
+            const std::string& blockPath,
+            const Pothos::Object* args,
+            const size_t numArgs)
+        {
+            static const Pothos::DType OutDType(typeid(OutType));
+
+            // If the caller asks for an output type other than the function's,
+            // the Python implementation handles the conversion.
+            if((1 == numArgs) || ((2 == numArgs) && (OutDType == objectToDType(args[1]))))
+            {
+                return new OneToOneBlock(blockPath);
+            }
+
+            return nullptr;
+        }
+
+        OneToOneBlock(const std::string& blockPath): BaseBlock(blockPath)
+        {
+            this->setupInput(0, Pothos::DType(typeid(InType)));
+            this->setupOutput(0, Pothos::DType(typeid(OutType)));
+        }
+
+        virtual ~OneToOneBlock() = default;
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minElements;
+            if(!this->countWork(elems)) return;
+
+            auto input = this->input(0);
+            auto output = this->output(0);
+
+            this->timeFunc([&]()
+            {
+                UnaryKernel<Func>::run(
+                    input->buffer(),
+                    output->buffer(),
+                    elems);
+            });
+
+            input->consume(elems);
+            output->produce(elems);
+            this->countElements(elems, elems);
+        }
+};
+
+}
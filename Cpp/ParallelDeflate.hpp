@@ -0,0 +1,259 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <Pothos/Exception.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// Compresses a raw deflate stream in independent chunks on worker threads,
+// as pigz does, so compression keeps up with the flow instead of stalling
+// it. Each chunk is primed with the end of the previous chunk as a preset
+// dictionary, so the compression ratio is close to a single-threaded
+// stream, and every chunk but the last ends on a byte boundary with a sync
+// flush, so the chunks' outputs can be concatenated into one standard
+// deflate stream.
+//
+
+namespace detail
+{
+    // pigz's default
+    static constexpr size_t DeflateChunkSize = 1 << 17;
+
+    // The largest distance a deflate stream can refer back
+    static constexpr size_t DeflateWindowSize = 1 << 15;
+
+    struct DeflateChunk
+    {
+        std::string input;
+        std::string dictionary;
+        bool last;
+
+        std::string output;
+        uLong crc;
+    };
+
+    static inline void deflateChunk(DeflateChunk& chunk, const int level)
+    {
+        z_stream zstream = z_stream();
+        if(Z_OK != deflateInit2(&zstream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY))
+        {
+            throw Pothos::RuntimeException("Failed to initialize zlib");
+        }
+
+        if(!chunk.dictionary.empty())
+        {
+            deflateSetDictionary(
+                &zstream,
+                reinterpret_cast<const Bytef*>(chunk.dictionary.data()),
+                uInt(chunk.dictionary.size()));
+        }
+
+        zstream.next_in = reinterpret_cast<Bytef*>(&chunk.input[0]);
+        zstream.avail_in = uInt(chunk.input.size());
+
+        // deflateBound() doesn't count the sync flush's empty block.
+        chunk.output.resize(deflateBound(&zstream, uLong(chunk.input.size())) + 16);
+
+        size_t outputSize = 0;
+        while(true)
+        {
+            zstream.next_out = reinterpret_cast<Bytef*>(&chunk.output[outputSize]);
+            zstream.avail_out = uInt(chunk.output.size() - outputSize);
+
+            const auto status = deflate(&zstream, chunk.last ? Z_FINISH : Z_SYNC_FLUSH);
+            outputSize = chunk.output.size() - zstream.avail_out;
+
+            if(Z_STREAM_ERROR == status)
+            {
+                deflateEnd(&zstream);
+                throw Pothos::RuntimeException("Failed to compress data");
+            }
+            if(zstream.avail_out > 0) break;
+
+            chunk.output.resize(chunk.output.size() * 2);
+        }
+
+        deflateEnd(&zstream);
+        chunk.output.resize(outputSize);
+
+        chunk.crc = ::crc32(
+                        ::crc32(0, Z_NULL, 0),
+                        reinterpret_cast<const Bytef*>(chunk.input.data()),
+                        uInt(chunk.input.size()));
+    }
+}
+
+class ParallelDeflater
+{
+    public:
+        // Called on the writing thread with each piece of compressed output,
+        // in order
+        using OutputFcn = std::function<void(const char*, size_t)>;
+
+        // By default, one thread is used per core.
+        explicit ParallelDeflater(
+            const OutputFcn& output,
+            const size_t numThreads = 0,
+            const int level = Z_DEFAULT_COMPRESSION
+        ):
+            _output(output),
+            _level(level),
+            _maxInFlight(0),
+            _stopping(false),
+            _crc(::crc32(0, Z_NULL, 0))
+        {
+            const size_t threadCount = (numThreads > 0) ? numThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+            // Enough to keep every thread busy while the oldest chunk is
+            // written, without buffering an unbounded amount of input.
+            _maxInFlight = 2 * threadCount;
+
+            for(size_t thread = 0; thread < threadCount; ++thread)
+            {
+                _threads.emplace_back(&ParallelDeflater::workerLoop, this);
+            }
+
+            _input.reserve(detail::DeflateChunkSize);
+        }
+
+        virtual ~ParallelDeflater()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _cond.notify_all();
+
+            for(auto& thread: _threads) thread.join();
+        }
+
+        void write(const void* data, const size_t size)
+        {
+            const auto* bytes = reinterpret_cast<const char*>(data);
+            for(size_t pos = 0; pos < size;)
+            {
+                const size_t copySize = std::min(size - pos, detail::DeflateChunkSize - _input.size());
+                _input.append(bytes + pos, copySize);
+                pos += copySize;
+
+                if(detail::DeflateChunkSize == _input.size()) this->submit(false);
+            }
+
+            this->writeFinished(false);
+        }
+
+        // Compress and output everything written so far, and end the stream.
+        void finish()
+        {
+            this->submit(true);
+            this->writeFinished(true);
+        }
+
+        // The CRC-32 of the input whose output has been written
+        uLong crc() const
+        {
+            return _crc;
+        }
+
+    private:
+        using ChunkPtr = std::shared_ptr<detail::DeflateChunk>;
+
+        OutputFcn _output;
+        int _level;
+        size_t _maxInFlight;
+
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        std::deque<std::packaged_task<void()>> _tasks;
+        bool _stopping;
+
+        // Chunks in the order they were submitted
+        std::deque<std::pair<ChunkPtr, std::future<void>>> _inFlight;
+
+        std::string _input;
+        std::string _dictionary;
+        uLong _crc;
+
+        void workerLoop()
+        {
+            while(true)
+            {
+                std::packaged_task<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cond.wait(lock, [this](){return _stopping || !_tasks.empty();});
+                    if(_tasks.empty()) return;
+
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                // Exceptions are passed to the writing thread through the
+                // task's future.
+                task();
+            }
+        }
+
+        void submit(const bool last)
+        {
+            ChunkPtr chunk(new detail::DeflateChunk());
+            chunk->input.swap(_input);
+            chunk->dictionary.swap(_dictionary);
+            chunk->last = last;
+
+            const size_t dictionarySize = std::min(chunk->input.size(), detail::DeflateWindowSize);
+            _dictionary.assign(chunk->input, chunk->input.size() - dictionarySize, dictionarySize);
+            _input.reserve(detail::DeflateChunkSize);
+
+            const int level = _level;
+            std::packaged_task<void()> task([chunk, level](){detail::deflateChunk(*chunk, level);});
+            _inFlight.emplace_back(chunk, task.get_future());
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.emplace_back(std::move(task));
+            }
+            _cond.notify_one();
+        }
+
+        // Output chunks that are done, in order. Waits for chunks if too
+        // many are in flight, or for all of them if wait is set.
+        void writeFinished(const bool wait)
+        {
+            while(!_inFlight.empty())
+            {
+                auto& front = _inFlight.front();
+                const bool mustWait = wait || (_inFlight.size() > _maxInFlight);
+                if(!mustWait && (std::future_status::ready != front.second.wait_for(std::chrono::seconds(0)))) break;
+
+                front.second.get();
+
+                const auto& chunk = *front.first;
+                _output(chunk.output.data(), chunk.output.size());
+                _crc = crc32_combine64(_crc, chunk.crc, z_off64_t(chunk.input.size()));
+
+                _inFlight.pop_front();
+            }
+        }
+};
+
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/FileSinkBlock.hpp"
+#include "Cpp/NpyFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Streams samples to disk as they arrive, through a background writer, with
+// no header. Each write is copied into one of the writer's buffers, so the
+// input is consumed right away. Swapping the byte order adds one more copy
+// before that.
+//
+
+class RawFileSink: public PothosNumPy::FileSinkBlock
+{
+    public:
+        RawFileSink(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const std::string& byteOrder,
+            const bool append
+        ):
+            PothosNumPy::FileSinkBlock("/numpy/tofile"),
+            _filepath(filepath),
+            _byteOrder(byteOrder),
+            _append(append),
+            _elemSize(dtype.elemSize()),
+            _swapSize(0)
+        {
+            // Validates the type.
+            (void)PothosNumPy::dtypeToNpyDescr(dtype);
+
+            const auto wordSize = PothosNumPy::getByteSwapWordSize(dtype);
+            if(PothosNumPy::isByteOrderSwapped(byteOrder) && (wordSize > 1)) _swapSize = wordSize;
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(RawFileSink, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(RawFileSink, byteOrder));
+            this->registerCall(this, POTHOS_FCN_TUPLE(RawFileSink, append));
+
+            this->setupInput(0, dtype);
+        }
+
+        virtual ~RawFileSink() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        std::string byteOrder() const
+        {
+            return _byteOrder;
+        }
+
+        bool append() const
+        {
+            return _append;
+        }
+
+        void activate() override
+        {
+            const bool appending = _append && Poco::File(_filepath).exists();
+
+            _file.reset(new PothosNumPy::AsyncFileWriter(
+                _filepath,
+                !appending,
+                this->fileSyncMode(),
+                this->fileSyncInterval()));
+
+            if(appending) _file->seek(Poco::File(_filepath).getSize());
+        }
+
+        void deactivate() override
+        {
+            _file->close();
+        }
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllInElements;
+            if(!this->countWork(elems)) return;
+
+            auto* input = this->input(0);
+            const auto* data = input->buffer().as<const char*>();
+            const auto size = elems * _elemSize;
+
+            if(_swapSize > 0)
+            {
+                this->timeCopy([&]()
+                {
+                    _swapBuffer.resize(size);
+                    std::memcpy(_swapBuffer.data(), data, size);
+                    PothosNumPy::byteswapWords(_swapBuffer.data(), size, _swapSize);
+                });
+                data = _swapBuffer.data();
+            }
+
+            this->timeFunc([&](){_file->write(data, size);});
+
+            input->consume(elems);
+            this->countElements(elems, 0);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _byteOrder;
+        bool _append;
+        size_t _elemSize;
+
+        // Nonzero if each word of this many bytes must be byteswapped
+        size_t _swapSize;
+
+        std::vector<char> _swapBuffer;
+        std::unique_ptr<PothosNumPy::AsyncFileWriter> _file;
+
+        const PothosNumPy::AsyncFileWriter* fileWriter() const override
+        {
+            return _file.get();
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc Raw File Sink
+ *
+ * Corresponding NumPy function: <b>numpy.ndarray.tofile</b>
+ *
+ * Writes samples to a file with no header, which can be read back with
+ * <b>numpy.fromfile</b> or the Raw File Source, given the same type and
+ * byte order. When appending, samples are added to the end of the file
+ * as-is.
+ *
+ * Samples are written to disk on a background thread in large,
+ * page-aligned writes, so disk latency only stalls the topology once every
+ * write buffer is full. The writeQueueDepth and writeBlockedSeconds probes
+ * show how well the disk is keeping up.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sinks/NumPy
+ * |keywords save raw binary file IO tofile
+ * |factory /numpy/tofile(filepath,dtype,byteOrder,append)
+ * |setter setSyncMode(syncMode)
+ * |setter setSyncIntervalMB(syncIntervalMB)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "complex_float32"
+ * |preview disable
+ *
+ * |param byteOrder[Byte Order] The byte order of the samples in the file.
+ * |option [Native] "native"
+ * |option [Little-Endian] "little"
+ * |option [Big-Endian] "big"
+ * |widget ComboBox(editable=false)
+ * |default "native"
+ * |preview enable
+ *
+ * |param append[Append?]
+ * |default false
+ * |widget ToggleSwitch(on="True",off="False")
+ * |preview enable
+ *
+ * |param syncMode[Sync Mode] When the file is flushed to disk. Only this file is synced, not the whole filesystem.
+ * |option [Never] "never"
+ * |option [On Close] "close"
+ * |option [Every N MB] "interval"
+ * |widget ComboBox(editable=false)
+ * |default "close"
+ * |preview disable
+ *
+ * |param syncIntervalMB[Sync Interval] How much is written between syncs in the "Every N MB" mode.
+ * |widget DoubleSpinBox(minimum=1)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeRawFileSink(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const std::string& byteOrder,
+    const bool append)
+{
+    return new RawFileSink(filepath, dtype, byteOrder, append);
+}
+
+static Pothos::BlockRegistry registerNumPyToFile(
+    "/numpy/tofile",
+    Pothos::Callable(&makeRawFileSink));
@@ -0,0 +1,182 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/MappedArray.hpp"
+#include "Cpp/MappedFileSource.hpp"
+#include "Cpp/NpyFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+
+#include <cstdint>
+#include <string>
+
+//
+// Plays a headerless file of samples, such as a raw capture, straight out of
+// a memory mapping. The layout comes entirely from the block's parameters.
+//
+
+class RawFileSource: public PothosNumPy::MappedFileSource
+{
+    public:
+        RawFileSource(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const size_t offset,
+            const std::string& byteOrder,
+            const bool repeat
+        ):
+            PothosNumPy::MappedFileSource("/numpy/fromfile", filepath, repeat),
+            _offset(offset),
+            _byteOrder(byteOrder)
+        {
+            // Validates the type.
+            (void)PothosNumPy::dtypeToNpyDescr(dtype);
+
+            const auto fileSize = Poco::File(filepath).getSize();
+            if(offset > fileSize)
+            {
+                throw Pothos::InvalidArgumentException(
+                          "Offset "+std::to_string(offset)+" is past the end of the file",
+                          std::to_string(fileSize));
+            }
+
+            // Like numpy.fromfile, a partial sample at the end is ignored.
+            this->setArray(PothosNumPy::MappedArray(
+                filepath,
+                dtype,
+                offset,
+                1,
+                size_t((fileSize - offset) / dtype.elemSize()),
+                PothosNumPy::isByteOrderSwapped(byteOrder),
+                false));
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(RawFileSource, offset));
+            this->registerCall(this, POTHOS_FCN_TUPLE(RawFileSource, byteOrder));
+        }
+
+        virtual ~RawFileSource() = default;
+
+        size_t offset() const
+        {
+            return _offset;
+        }
+
+        std::string byteOrder() const
+        {
+            return _byteOrder;
+        }
+
+    private:
+        size_t _offset;
+        std::string _byteOrder;
+};
+
+/***********************************************************************
+ * |PothosDoc Raw File Source
+ *
+ * Corresponding NumPy function: <b>numpy.fromfile</b>
+ *
+ * Reads a file with no header, such as a raw capture, as a 1D array of
+ * the given type, starting <b>offset</b> bytes into the file. A partial
+ * sample at the end of the file is ignored.
+ *
+ * The file is memory-mapped, and the output buffers point directly into
+ * the mapping, so samples are not copied unless they must be byteswapped,
+ * or the offset isn't a multiple of the type's size.
+ *
+ * Playback can be limited to <b>count</b> samples starting at
+ * <b>startIndex</b>, and repeat mode loops over just that window. At
+ * runtime, the <b>seek</b> slot moves playback to any index within the
+ * window.
+ *
+ * By default, pages are read from disk as they're first accessed, which
+ * is slow for files that aren't already cached. Setting <b>readAheadMB</b>
+ * asks the OS to read that far ahead of playback. For recordings larger
+ * than memory, <b>dropReadPages</b> releases pages once playback is well
+ * past them, and the droppedReadMB probe shows how much was released.
+ * <b>prefetchThread</b> reads ahead on a separate thread for systems that
+ * ignore read-ahead hints.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sources/NumPy
+ * |keywords load raw binary file IO mmap fromfile
+ * |factory /numpy/fromfile(filepath,dtype,offset,byteOrder,repeat)
+ * |setter setRepeat(repeat)
+ * |setter setStartIndex(startIndex)
+ * |setter setCount(count)
+ * |setter setReadAheadMB(readAheadMB)
+ * |setter setDropReadPages(dropReadPages)
+ * |setter setPrefetchThread(prefetchThread)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=open)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "complex_float32"
+ * |preview disable
+ *
+ * |param offset[Offset] The number of bytes to skip at the start of the file.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |units bytes
+ * |preview enable
+ *
+ * |param byteOrder[Byte Order] The byte order of the samples in the file.
+ * |option [Native] "native"
+ * |option [Little-Endian] "little"
+ * |option [Big-Endian] "big"
+ * |widget ComboBox(editable=false)
+ * |default "native"
+ * |preview enable
+ *
+ * |param repeat[Repeat?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ *
+ * |param startIndex[Start Index] The first sample to output.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param count[Count] The number of samples to output. 0 outputs everything after the start index.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param readAheadMB[Read-Ahead] How far ahead of playback to read. 0 disables read-ahead.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |units MB
+ * |preview disable
+ *
+ * |param dropReadPages[Drop Read Pages?] Release pages from memory once playback is past them.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview disable
+ *
+ * |param prefetchThread[Prefetch Thread?] Read ahead on a background thread.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeRawFileSource(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const size_t offset,
+    const std::string& byteOrder,
+    const bool repeat)
+{
+    return new RawFileSource(filepath, dtype, offset, byteOrder, repeat);
+}
+
+static Pothos::BlockRegistry registerNumPyFromFile(
+    "/numpy/fromfile",
+    Pothos::Callable(&makeRawFileSource));
@@ -0,0 +1,221 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/FileSinkBlock.hpp"
+#include "Cpp/TextFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// Formats samples as they arrive and streams them to disk through a
+// background writer, one row per sample with one column per channel.
+//
+
+class TextFileSink: public PothosNumPy::FileSinkBlock
+{
+    public:
+        TextFileSink(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const size_t nchans,
+            const std::string& delimiter,
+            const bool append
+        ):
+            PothosNumPy::FileSinkBlock("/numpy/savetxt"),
+            _filepath(filepath),
+            _delimiter(delimiter),
+            _append(append),
+            _formatFcn(PothosNumPy::getTextFormatFcn(dtype))
+        {
+            if(0 == nchans)
+            {
+                throw Pothos::InvalidArgumentException("Number of channels must be positive.");
+            }
+            if(delimiter.empty() || (std::string::npos != delimiter.find_first_of("\n#")))
+            {
+                throw Pothos::InvalidArgumentException("The delimiter must be non-empty and can't contain a newline or \"#\".", delimiter);
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSink, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSink, delimiter));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSink, append));
+
+            for(size_t chan = 0; chan < nchans; ++chan)
+            {
+                this->setupInput(chan, dtype);
+            }
+        }
+
+        virtual ~TextFileSink() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        std::string delimiter() const
+        {
+            return _delimiter;
+        }
+
+        bool append() const
+        {
+            return _append;
+        }
+
+        void activate() override
+        {
+            const bool appending = _append && Poco::File(_filepath).exists();
+            const auto fileSize = appending ? Poco::File(_filepath).getSize() : 0;
+
+            _file.reset(new PothosNumPy::AsyncFileWriter(
+                _filepath,
+                !appending,
+                this->fileSyncMode(),
+                this->fileSyncInterval()));
+
+            if(fileSize > 0)
+            {
+                _file->seek(fileSize);
+
+                // Don't continue a row that wasn't finished.
+                if(!this->endsWithNewline(fileSize)) _file->write("\n", 1);
+            }
+        }
+
+        void deactivate() override
+        {
+            _file->close();
+        }
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllInElements;
+            if(!this->countWork(elems)) return;
+
+            const auto& inputs = this->inputs();
+
+            std::vector<const char*> inputBuffers;
+            for(auto* input: inputs) inputBuffers.emplace_back(input->buffer().as<const char*>());
+
+            this->timeFunc([&]()
+            {
+                _text.clear();
+                _formatFcn(inputBuffers, elems, _delimiter, _text);
+
+                _file->write(_text.data(), _text.size());
+            });
+
+            for(auto* input: inputs) input->consume(elems);
+            this->countElements(elems, 0);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _delimiter;
+        bool _append;
+
+        PothosNumPy::TextFormatFcn _formatFcn;
+        std::string _text;
+        std::unique_ptr<PothosNumPy::AsyncFileWriter> _file;
+
+        const PothosNumPy::AsyncFileWriter* fileWriter() const override
+        {
+            return _file.get();
+        }
+
+        bool endsWithNewline(const std::uint64_t fileSize) const
+        {
+            std::ifstream stream(_filepath, std::ios::in | std::ios::binary);
+            stream.seekg(std::streamoff(fileSize - 1));
+
+            return ('\n' == stream.get());
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc Text File Sink
+ *
+ * Corresponding NumPy function: <b>numpy.savetxt</b>
+ *
+ * Writes a delimited text file, such as a CSV file, with one row per
+ * sample and one column per channel, which can be read back with
+ * <b>numpy.loadtxt</b>. Each value is written with as few digits as
+ * possible while still reading back as the same value.
+ *
+ * Samples are formatted as they arrive and written to disk on a background
+ * thread, so disk latency only stalls the topology once every write buffer
+ * is full. The writeQueueDepth and writeBlockedSeconds probes show how
+ * well the disk is keeping up.
+ *
+ * Only integer and real floating-point types are supported.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sinks/NumPy
+ * |keywords save text csv tsv file IO savetxt
+ * |factory /numpy/savetxt(filepath,dtype,nchans,delimiter,append)
+ * |setter setSyncMode(syncMode)
+ * |setter setSyncIntervalMB(syncIntervalMB)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Channels] The number of inputs, each of which is written as a column.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param delimiter[Delimiter] The string between columns.
+ * |widget StringEntry()
+ * |default ","
+ * |preview enable
+ *
+ * |param append[Append?]
+ * |default false
+ * |widget ToggleSwitch(on="True",off="False")
+ * |preview enable
+ *
+ * |param syncMode[Sync Mode] When the file is flushed to disk. Only this file is synced, not the whole filesystem.
+ * |option [Never] "never"
+ * |option [On Close] "close"
+ * |option [Every N MB] "interval"
+ * |widget ComboBox(editable=false)
+ * |default "close"
+ * |preview disable
+ *
+ * |param syncIntervalMB[Sync Interval] How much is written between syncs in the "Every N MB" mode.
+ * |widget DoubleSpinBox(minimum=1)
+ * |default 64.0
+ * |units MB
+ * |preview disable
+ **********************************************************************/
+static Pothos::Block* makeTextFileSink(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const size_t nchans,
+    const std::string& delimiter,
+    const bool append)
+{
+    return new TextFileSink(filepath, dtype, nchans, delimiter, append);
+}
+
+static Pothos::BlockRegistry registerNumPySaveTxt(
+    "/numpy/savetxt",
+    Pothos::Callable(&makeTextFileSink));
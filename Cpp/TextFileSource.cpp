@@ -0,0 +1,285 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/TextFormat.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <Poco/File.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+//
+// Parses the file on worker threads as it's output, so memory use doesn't
+// depend on the size of the file, and parsing keeps up with the disk. Each
+// column is output on its own port.
+//
+
+class TextFileSource: public PothosNumPy::BaseBlock
+{
+    public:
+        TextFileSource(
+            const std::string& filepath,
+            const Pothos::DType& dtype,
+            const std::string& delimiter,
+            const size_t skipRows,
+            const bool repeat
+        ):
+            PothosNumPy::BaseBlock("/numpy/loadtxt"),
+            _filepath(filepath),
+            _delimiter(delimiter),
+            _skipRows(skipRows),
+            _repeat(repeat),
+            _elemSize(dtype.elemSize()),
+            _parseFcn(PothosNumPy::getTextParseFcn(dtype)),
+            _dataOffset(0),
+            _row(0),
+            _passRows(0)
+        {
+            if(!Poco::File(filepath).exists())
+            {
+                throw Pothos::FileNotFoundException("The given file does not exist", filepath);
+            }
+
+            _options.delimiter = getDelimiterChar(delimiter);
+            _options.comment = '#';
+            _options.numColumns = 0;
+            _options.filepath = filepath;
+
+            std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+            if(!stream)
+            {
+                throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+            }
+
+            std::string line;
+            for(size_t row = 0; (row < skipRows) && std::getline(stream, line); ++row) {}
+            _dataOffset = stream.eof() ? Poco::File(filepath).getSize() : std::uint64_t(stream.tellg());
+
+            while((0 == _options.numColumns) && std::getline(stream, line))
+            {
+                _options.numColumns = PothosNumPy::countTextColumns(line, _options);
+            }
+            if(0 == _options.numColumns)
+            {
+                throw Pothos::DataFormatException("The file has no values", filepath);
+            }
+
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSource, filepath));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSource, delimiter));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSource, skipRows));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSource, repeat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(TextFileSource, setRepeat));
+
+            for(size_t chan = 0; chan < _options.numColumns; ++chan)
+            {
+                this->setupOutput(chan, dtype);
+            }
+        }
+
+        virtual ~TextFileSource() = default;
+
+        std::string filepath() const
+        {
+            return _filepath;
+        }
+
+        std::string delimiter() const
+        {
+            return _delimiter;
+        }
+
+        size_t skipRows() const
+        {
+            return _skipRows;
+        }
+
+        bool repeat() const
+        {
+            return _repeat;
+        }
+
+        void setRepeat(const bool repeat)
+        {
+            _repeat = repeat;
+        }
+
+        void activate() override
+        {
+            this->startParser();
+        }
+
+        void deactivate() override
+        {
+            _parser.reset();
+            _chunk.reset();
+        }
+
+        void work() override
+        {
+            if(!this->nextChunk()) return;
+
+            const auto elems = std::min(
+                this->workInfo().minAllOutElements,
+                _chunk->numRows - _row);
+            if(!this->countWork(elems)) return;
+
+            this->timeCopy([&]()
+            {
+                for(size_t chan = 0; chan < _options.numColumns; ++chan)
+                {
+                    std::memcpy(
+                        this->output(chan)->buffer().as<char*>(),
+                        _chunk->columns[chan].data() + (_row * _elemSize),
+                        elems * _elemSize);
+                }
+            });
+
+            for(size_t chan = 0; chan < _options.numColumns; ++chan)
+            {
+                this->output(chan)->produce(elems);
+            }
+
+            _row += elems;
+            this->countElements(0, elems);
+        }
+
+    private:
+        std::string _filepath;
+        std::string _delimiter;
+        size_t _skipRows;
+        bool _repeat;
+
+        size_t _elemSize;
+        PothosNumPy::TextParseFcn _parseFcn;
+        PothosNumPy::TextParseOptions _options;
+        std::uint64_t _dataOffset;
+
+        std::unique_ptr<PothosNumPy::ParallelTextParser> _parser;
+        std::unique_ptr<PothosNumPy::TextChunk> _chunk;
+        size_t _row;
+
+        // Rows output since the parser started, so an empty file isn't
+        // repeated forever
+        size_t _passRows;
+
+        static char getDelimiterChar(const std::string& delimiter)
+        {
+            // Like numpy.loadtxt, no delimiter means any whitespace.
+            if(delimiter.empty() || (" " == delimiter)) return '\0';
+            if((1 != delimiter.size()) || ('\n' == delimiter[0]) || ('#' == delimiter[0]))
+            {
+                throw Pothos::InvalidArgumentException("The delimiter must be a single character", delimiter);
+            }
+
+            return delimiter[0];
+        }
+
+        void startParser()
+        {
+            _parser.reset(new PothosNumPy::ParallelTextParser(
+                _filepath,
+                _dataOffset,
+                Poco::File(_filepath).getSize(),
+                _parseFcn,
+                _options));
+            _chunk.reset();
+            _row = 0;
+            _passRows = 0;
+        }
+
+        // Move to the next chunk with rows left, starting over at the end of
+        // the file if repeating. Returns false at the end of the file.
+        bool nextChunk()
+        {
+            while(!_chunk || (_row == _chunk->numRows))
+            {
+                // Time spent waiting on the parser threads
+                std::unique_ptr<PothosNumPy::TextChunk> chunk;
+                this->timeFunc([&](){chunk = _parser->next();});
+
+                if(!chunk)
+                {
+                    if(!_repeat || (0 == _passRows)) return false;
+
+                    this->startParser();
+                    continue;
+                }
+
+                _chunk = std::move(chunk);
+                _row = 0;
+                _passRows += _chunk->numRows;
+            }
+
+            return true;
+        }
+};
+
+/***********************************************************************
+ * |PothosDoc Text File Source
+ *
+ * Corresponding NumPy function: <b>numpy.loadtxt</b>
+ *
+ * Reads a delimited text file, such as a CSV file, with one row per line.
+ * Each column is output on its own port, and the number of columns is
+ * taken from the first row. Lines starting with "#", and anything after a
+ * "#" in a line, are ignored.
+ *
+ * The file is split into line-aligned chunks, which are read and parsed on
+ * one thread per core, so only a few chunks are in memory at a time, and
+ * large files are read at close to the speed of the disk.
+ *
+ * Only integer and real floating-point types are supported.
+ *
+ * |category /NumPy/File IO
+ * |category /File IO/NumPy
+ * |category /Sources/NumPy
+ * |keywords load text csv tsv file IO loadtxt
+ * |factory /numpy/loadtxt(filepath,dtype,delimiter,skipRows,repeat)
+ * |setter setRepeat(repeat)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=open)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param delimiter[Delimiter] The character between columns. If empty, columns are separated by any whitespace.
+ * |widget StringEntry()
+ * |default ","
+ * |preview enable
+ *
+ * |param skipRows[Skip Rows] The number of lines to skip at the start of the file, such as a header.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ *
+ * |param repeat[Repeat?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ **********************************************************************/
+static Pothos::Block* makeTextFileSource(
+    const std::string& filepath,
+    const Pothos::DType& dtype,
+    const std::string& delimiter,
+    const size_t skipRows,
+    const bool repeat)
+{
+    return new TextFileSource(filepath, dtype, delimiter, skipRows, repeat);
+}
+
+static Pothos::BlockRegistry registerNumPyLoadTxt(
+    "/numpy/loadtxt",
+    Pothos::Callable(&makeTextFileSource));
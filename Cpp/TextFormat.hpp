@@ -0,0 +1,569 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework/DType.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+// std::from_chars and std::to_chars are locale-independent and much faster
+// than strtod and snprintf, but floating-point support requires C++17 and a
+// recent standard library, so the C functions are used as a fallback.
+#if defined(__has_include)
+#if __has_include(<charconv>) && ((__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)))
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars)
+#define POTHOS_NUMPY_HAS_CHARCONV
+#endif
+
+namespace PothosNumPy
+{
+
+//
+// Reading and writing delimited text, in the format numpy.loadtxt and
+// numpy.savetxt use: one row per line, one column per channel, and "#"
+// comments. Only integer and real floating-point types are supported.
+//
+
+struct TextParseOptions
+{
+    // '\0' splits columns on any run of whitespace.
+    char delimiter;
+    char comment;
+    size_t numColumns;
+
+    // For error messages
+    std::string filepath;
+};
+
+// A line-aligned piece of a file and the values parsed from it
+struct TextChunk
+{
+    std::string text;
+
+    // The file offset of text[0]
+    std::uint64_t offset;
+
+    std::vector<std::vector<char>> columns;
+    size_t numRows;
+};
+
+using TextParseFcn = void(*)(TextChunk&, const TextParseOptions&);
+using TextFormatFcn = void(*)(const std::vector<const char*>&, size_t, const std::string&, std::string&);
+
+namespace detail
+{
+    // A whitespace delimiter, such as '\t', separates fields like any other
+    // delimiter, so it isn't skipped as whitespace, and empty fields around
+    // it are caught.
+    static inline bool isTextSpace(const char c, const char delimiter)
+    {
+        return (c != delimiter) && ((' ' == c) || ('\t' == c) || ('\r' == c));
+    }
+
+    static inline const char* skipTextSpace(const char* begin, const char* end, const char delimiter)
+    {
+        while((begin < end) && isTextSpace(*begin, delimiter)) ++begin;
+        return begin;
+    }
+
+    // The end of the line's content, excluding any comment and trailing
+    // whitespace
+    static inline const char* getTextContentEnd(const char* begin, const char* end, const TextParseOptions& options)
+    {
+        const auto* commentPos = reinterpret_cast<const char*>(std::memchr(begin, options.comment, end - begin));
+        if(commentPos) end = commentPos;
+        while((end > begin) && isTextSpace(*(end-1), options.delimiter)) --end;
+
+        return end;
+    }
+
+    static inline const char* findTextDelimiter(const char* begin, const char* end, const char delimiter)
+    {
+        if('\0' != delimiter)
+        {
+            const auto* pos = reinterpret_cast<const char*>(std::memchr(begin, delimiter, end - begin));
+            return pos ? pos : end;
+        }
+
+        while((begin < end) && !isTextSpace(*begin, delimiter)) ++begin;
+        return begin;
+    }
+
+    //
+    // Parsing a single value, which must take up the whole field
+    //
+
+#ifdef POTHOS_NUMPY_HAS_CHARCONV
+    template <typename T>
+    static inline bool parseTextValue(const char* begin, const char* end, T& value)
+    {
+        // Unlike NumPy, from_chars doesn't accept a leading '+'.
+        if((begin < end) && ('+' == *begin)) ++begin;
+
+        const auto result = std::from_chars(begin, end, value);
+        return (std::errc() == result.ec) && (end == result.ptr);
+    }
+#else
+    // The text is always followed by a delimiter, newline, or the string's
+    // null terminator, so the C functions stop at the end of the field.
+    template <typename T>
+    static inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type parseTextValue(
+        const char* begin,
+        const char* end,
+        T& value)
+    {
+        char* parseEnd = nullptr;
+        errno = 0;
+        const auto parsed = std::strtod(begin, &parseEnd);
+        value = T(parsed);
+
+        return (parseEnd == end) && (begin < end) && (ERANGE != errno);
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, bool>::type parseTextValue(
+        const char* begin,
+        const char* end,
+        T& value)
+    {
+        char* parseEnd = nullptr;
+        errno = 0;
+        const auto parsed = std::strtoll(begin, &parseEnd, 10);
+        value = T(parsed);
+
+        return (parseEnd == end) && (begin < end) && (ERANGE != errno) &&
+               (parsed >= std::numeric_limits<T>::min()) && (parsed <= std::numeric_limits<T>::max());
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, bool>::type parseTextValue(
+        const char* begin,
+        const char* end,
+        T& value)
+    {
+        // strtoull accepts negative numbers and wraps them around.
+        if((begin < end) && ('-' == *begin)) return false;
+
+        char* parseEnd = nullptr;
+        errno = 0;
+        const auto parsed = std::strtoull(begin, &parseEnd, 10);
+        value = T(parsed);
+
+        return (parseEnd == end) && (begin < end) && (ERANGE != errno) &&
+               (parsed <= std::numeric_limits<T>::max());
+    }
+#endif
+
+    //
+    // Formatting a single value, as the shortest string that parses back
+    // to the same value
+    //
+
+#ifdef POTHOS_NUMPY_HAS_CHARCONV
+    template <typename T>
+    static inline void formatTextValue(const T value, std::string& output)
+    {
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        output.append(buffer, result.ptr);
+    }
+#else
+    static inline void appendTextValue(std::string& output, const int size, const char* buffer)
+    {
+        if(size > 0) output.append(buffer, size_t(size));
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_floating_point<T>::value>::type formatTextValue(
+        const T value,
+        std::string& output)
+    {
+        char buffer[64];
+        appendTextValue(output, std::snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<T>::max_digits10, double(value)), buffer);
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type formatTextValue(
+        const T value,
+        std::string& output)
+    {
+        char buffer[32];
+        appendTextValue(output, std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value)), buffer);
+    }
+
+    template <typename T>
+    static inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type formatTextValue(
+        const T value,
+        std::string& output)
+    {
+        char buffer[32];
+        appendTextValue(output, std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value)), buffer);
+    }
+#endif
+
+    //
+    // Whole chunks
+    //
+
+    template <typename T>
+    static inline void parseTextChunk(TextChunk& chunk, const TextParseOptions& options)
+    {
+        chunk.columns.assign(options.numColumns, std::vector<char>());
+        chunk.numRows = 0;
+
+        const char* textEnd = chunk.text.data() + chunk.text.size();
+        for(const char* lineBegin = chunk.text.data(); lineBegin < textEnd;)
+        {
+            const auto* newline = reinterpret_cast<const char*>(std::memchr(lineBegin, '\n', textEnd - lineBegin));
+            const char* lineEnd = newline ? newline : textEnd;
+
+            const char* pos = skipTextSpace(lineBegin, lineEnd, options.delimiter);
+            const char* contentEnd = getTextContentEnd(pos, lineEnd, options);
+
+            const auto columnCountError = [&]()
+            {
+                return Pothos::DataFormatException(
+                           "Expected "+std::to_string(options.numColumns)+" columns in the line at byte "+std::to_string(chunk.offset + (lineBegin - chunk.text.data())),
+                           options.filepath);
+            };
+
+            if(pos < contentEnd)
+            {
+                for(size_t col = 0;; ++col)
+                {
+                    if(col == options.numColumns) throw columnCountError();
+
+                    const char* fieldEnd = findTextDelimiter(pos, contentEnd, options.delimiter);
+                    const char* valueEnd = fieldEnd;
+                    while((valueEnd > pos) && isTextSpace(*(valueEnd-1), options.delimiter)) --valueEnd;
+
+                    // Empty fields, such as after a trailing delimiter,
+                    // are invalid, like in NumPy.
+                    T value;
+                    if(!parseTextValue(pos, valueEnd, value))
+                    {
+                        throw Pothos::DataFormatException(
+                                  "Invalid value \""+std::string(pos, valueEnd)+"\" at byte "+std::to_string(chunk.offset + (pos - chunk.text.data())),
+                                  options.filepath);
+                    }
+
+                    const auto* valueBytes = reinterpret_cast<const char*>(&value);
+                    chunk.columns[col].insert(chunk.columns[col].end(), valueBytes, valueBytes + sizeof(T));
+
+                    if(fieldEnd == contentEnd)
+                    {
+                        if((col + 1) != options.numColumns) throw columnCountError();
+
+                        ++chunk.numRows;
+                        break;
+                    }
+
+                    pos = skipTextSpace(fieldEnd + 1, contentEnd, options.delimiter);
+                }
+            }
+
+            lineBegin = lineEnd + 1;
+        }
+
+        // Only the parsed values are needed from here on.
+        chunk.text = std::string();
+    }
+
+    template <typename T>
+    static inline void formatTextRows(
+        const std::vector<const char*>& inputs,
+        const size_t numRows,
+        const std::string& delimiter,
+        std::string& output)
+    {
+        for(size_t row = 0; row < numRows; ++row)
+        {
+            for(size_t chan = 0; chan < inputs.size(); ++chan)
+            {
+                if(chan > 0) output += delimiter;
+                formatTextValue(reinterpret_cast<const T*>(inputs[chan])[row], output);
+            }
+            output += '\n';
+        }
+    }
+
+    struct TextParseFcnGetter
+    {
+        using Fcn = TextParseFcn;
+
+        template <typename T>
+        static Fcn get()
+        {
+            return &parseTextChunk<T>;
+        }
+    };
+
+    struct TextFormatFcnGetter
+    {
+        using Fcn = TextFormatFcn;
+
+        template <typename T>
+        static Fcn get()
+        {
+            return &formatTextRows<T>;
+        }
+    };
+}
+
+static inline TextParseFcn getTextParseFcn(const Pothos::DType& dtype)
+{
+    const auto fcn = getRealDTypeFcn<detail::TextParseFcnGetter>(dtype);
+    if(!fcn) throw Pothos::InvalidArgumentException("Unsupported text file type", dtype.name());
+
+    return fcn;
+}
+
+static inline TextFormatFcn getTextFormatFcn(const Pothos::DType& dtype)
+{
+    const auto fcn = getRealDTypeFcn<detail::TextFormatFcnGetter>(dtype);
+    if(!fcn) throw Pothos::InvalidArgumentException("Unsupported text file type", dtype.name());
+
+    return fcn;
+}
+
+// The number of columns in the first line with any values
+static inline size_t countTextColumns(const std::string& text, const TextParseOptions& options)
+{
+    const char* textEnd = text.data() + text.size();
+    for(const char* lineBegin = text.data(); lineBegin < textEnd;)
+    {
+        const auto* newline = reinterpret_cast<const char*>(std::memchr(lineBegin, '\n', textEnd - lineBegin));
+        const char* lineEnd = newline ? newline : textEnd;
+
+        const char* pos = detail::skipTextSpace(lineBegin, lineEnd, options.delimiter);
+        const char* contentEnd = detail::getTextContentEnd(pos, lineEnd, options);
+        if(pos < contentEnd)
+        {
+            size_t numColumns = 1;
+            while(true)
+            {
+                pos = detail::findTextDelimiter(pos, contentEnd, options.delimiter);
+                if(pos == contentEnd) return numColumns;
+
+                pos = detail::skipTextSpace(pos + 1, contentEnd, options.delimiter);
+                ++numColumns;
+            }
+        }
+
+        lineBegin = lineEnd + 1;
+    }
+
+    return 0;
+}
+
+//
+// Parses a text file on worker threads, in chunks of about ChunkSize bytes
+// that are read by the workers themselves. Each chunk is made up of the
+// lines that start within it, so chunks can be read and parsed without
+// knowing where the previous one ended. Chunks are returned in order.
+//
+
+class ParallelTextParser
+{
+    public:
+        static constexpr size_t DefaultChunkSize = 1 << 20;
+
+        // By default, one thread is used per core. The data starts at
+        // dataOffset, after any skipped rows.
+        ParallelTextParser(
+            const std::string& filepath,
+            const std::uint64_t dataOffset,
+            const std::uint64_t fileSize,
+            const TextParseFcn parseFcn,
+            const TextParseOptions& options,
+            const size_t numThreads = 0,
+            const size_t chunkSize = DefaultChunkSize
+        ):
+            _filepath(filepath),
+            _dataOffset(dataOffset),
+            _fileSize(fileSize),
+            _parseFcn(parseFcn),
+            _options(options),
+            _chunkSize(std::max<size_t>(chunkSize, 1)),
+            _maxInFlight(0),
+            _nextChunkOffset(dataOffset),
+            _stopping(false)
+        {
+            const size_t threadCount = (numThreads > 0) ? numThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+            // Enough to keep every thread busy while the oldest chunk is
+            // output, without reading ahead an unbounded amount.
+            _maxInFlight = 2 * threadCount;
+
+            for(size_t thread = 0; thread < threadCount; ++thread)
+            {
+                _threads.emplace_back(&ParallelTextParser::workerLoop, this);
+            }
+
+            this->submitChunks();
+        }
+
+        virtual ~ParallelTextParser()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _cond.notify_all();
+
+            for(auto& thread: _threads) thread.join();
+        }
+
+        // The next chunk in the file, waiting for it if needed, or null at
+        // the end of the file. Parse errors are thrown here.
+        std::unique_ptr<TextChunk> next()
+        {
+            if(_inFlight.empty()) return nullptr;
+
+            auto chunk = std::move(_inFlight.front().first);
+            auto future = std::move(_inFlight.front().second);
+            _inFlight.pop_front();
+
+            future.get();
+            this->submitChunks();
+
+            return chunk;
+        }
+
+    private:
+        std::string _filepath;
+        std::uint64_t _dataOffset;
+        std::uint64_t _fileSize;
+        TextParseFcn _parseFcn;
+        TextParseOptions _options;
+        size_t _chunkSize;
+        size_t _maxInFlight;
+
+        std::uint64_t _nextChunkOffset;
+        std::deque<std::pair<std::unique_ptr<TextChunk>, std::future<void>>> _inFlight;
+
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        std::deque<std::packaged_task<void()>> _tasks;
+        bool _stopping;
+
+        void workerLoop()
+        {
+            while(true)
+            {
+                std::packaged_task<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cond.wait(lock, [this](){return _stopping || !_tasks.empty();});
+                    if(_stopping) return;
+
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                // Exceptions are passed to the reading thread through the
+                // task's future.
+                task();
+            }
+        }
+
+        void submitChunks()
+        {
+            while((_inFlight.size() < _maxInFlight) && (_nextChunkOffset < _fileSize))
+            {
+                const auto begin = _nextChunkOffset;
+                const auto end = std::min<std::uint64_t>(begin + _chunkSize, _fileSize);
+                _nextChunkOffset = end;
+
+                std::unique_ptr<TextChunk> chunk(new TextChunk());
+                auto* chunkPtr = chunk.get();
+                std::packaged_task<void()> task([this, chunkPtr, begin, end]()
+                {
+                    this->readChunk(*chunkPtr, begin, end);
+                    _parseFcn(*chunkPtr, _options);
+                });
+
+                _inFlight.emplace_back(std::move(chunk), task.get_future());
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _tasks.emplace_back(std::move(task));
+                }
+                _cond.notify_one();
+            }
+        }
+
+        // Read the lines that start in [begin, end).
+        void readChunk(TextChunk& chunk, const std::uint64_t begin, const std::uint64_t end) const
+        {
+            std::ifstream stream(_filepath, std::ios::in | std::ios::binary);
+            if(!stream)
+            {
+                throw Pothos::OpenFileException("Failed to open file for reading", _filepath);
+            }
+
+            // A line starts at begin if the previous character ends a line,
+            // so that character is read too.
+            const auto readBegin = (begin > _dataOffset) ? (begin - 1) : begin;
+            std::string text(size_t(end - readBegin), '\0');
+            stream.seekg(std::streamoff(readBegin));
+            stream.read(&text[0], std::streamsize(text.size()));
+            if(size_t(stream.gcount()) != text.size())
+            {
+                throw Pothos::DataFormatException("Failed to read file", _filepath);
+            }
+
+            size_t firstLine = 0;
+            if(readBegin < begin)
+            {
+                firstLine = text.find('\n');
+                if(std::string::npos == firstLine) firstLine = text.size();
+                else ++firstLine;
+            }
+
+            // Finish the last line, which may continue past the end.
+            static constexpr size_t LineReadSize = 1 << 12;
+            while((end < _fileSize) && (firstLine < text.size()) && ('\n' != text.back()))
+            {
+                const auto oldSize = text.size();
+                text.resize(oldSize + LineReadSize);
+                stream.read(&text[oldSize], LineReadSize);
+                text.resize(oldSize + size_t(stream.gcount()));
+
+                const auto newline = text.find('\n', oldSize);
+                if(std::string::npos != newline) text.resize(newline + 1);
+                else if(0 == stream.gcount()) break;
+            }
+
+            chunk.offset = readBegin + firstLine;
+            chunk.text = text.substr(firstLine);
+        }
+};
+
+}
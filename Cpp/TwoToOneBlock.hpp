@@ -0,0 +1,73 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/BaseBlock.hpp"
+#include "Cpp/Kernels.hpp"
+#include "Cpp/Utility.hpp"
+
+#include <Pothos/Framework.hpp>
+
+#include <string>
+#include <typeinfo>
+
+namespace PothosNumPy
+{
+
+//
+// Native equivalent of TwoToOneBlock.py for stateless elementwise functions
+// of two inputs. Both inputs are read and the output written in a single pass.
+//
+
+template <typename Func>
+class TwoToOneBlock: public BaseBlock
+{
+    public:
+        using InType = typename Func::InType;
+        using OutType = typename Func::OutType;
+
+        // Factory parameters: (dtype)
+        static Pothos::Block* make(
+            const std::string& blockPath,
+            const Pothos::Object*,
+            const size_t numArgs)
+        {
+            return (1 == numArgs) ? new TwoToOneBlock(blockPath) : nullptr;
+        }
+
+        TwoToOneBlock(const std::string& blockPath): BaseBlock(blockPath)
+        {
+            this->setupInput(0, Pothos::DType(typeid(InType)));
+            this->setupInput(1, Pothos::DType(typeid(InType)));
+            this->setupOutput(0, Pothos::DType(typeid(OutType)));
+        }
+
+        virtual ~TwoToOneBlock() = default;
+
+        void work() override
+        {
+            const auto elems = this->workInfo().minAllElements;
+            if(!this->countWork(elems)) return;
+
+            auto input0 = this->input(0);
+            auto input1 = this->input(1);
+            auto output = this->output(0);
+
+            this->timeFunc([&]()
+            {
+                BinaryKernel<Func>::run(
+                    input0->buffer(),
+                    input1->buffer(),
+                    output->buffer(),
+                    elems);
+            });
+
+            input0->consume(elems);
+            input1->consume(elems);
+            output->produce(elems);
+            this->countElements(elems, elems);
+        }
+};
+
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <Pothos/Framework/DType.hpp>
+#include <Pothos/Object.hpp>
+
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+namespace PothosNumPy
+{
+
+//
+// Useful typedefs
+//
+
+template <typename T>
+struct IsComplex : std::false_type {};
+
+template <typename T>
+struct IsComplex<std::complex<T>> : std::true_type {};
+
+template <typename T, typename U>
+using EnableIfInteger = typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfUnsignedInt = typename std::enable_if<std::is_unsigned<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfAnyInt = typename std::enable_if<std::is_integral<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfNotInt = typename std::enable_if<!std::is_integral<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfFloat = typename std::enable_if<std::is_floating_point<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfComplex = typename std::enable_if<IsComplex<T>::value, U>::type;
+
+template <typename T, typename U>
+using EnableIfNotComplex = typename std::enable_if<!IsComplex<T>::value, U>::type;
+
+//
+// Utility functions
+//
+
+// Factory parameters may come in as either a DType or its string
+// representation, depending on where the block is instantiated.
+static inline Pothos::DType objectToDType(const Pothos::Object& obj)
+{
+    if(obj.type() == typeid(std::string))
+    {
+        return Pothos::DType(obj.extract<std::string>());
+    }
+
+    return obj.convert<Pothos::DType>();
+}
+
+template <typename T>
+static inline bool isDType(const Pothos::DType& dtype)
+{
+    static const Pothos::DType ThisDType(typeid(T));
+    return (ThisDType == dtype);
+}
+
+// For choosing a function template instantiation by DType. Getter::get<T>()
+// returns a Getter::Fcn for the given type. These return nullptr if the
+// DType isn't one of the integer and floating-point types, or one of the
+// complex types, respectively.
+template <typename Getter>
+static inline typename Getter::Fcn getRealDTypeFcn(const Pothos::DType& dtype)
+{
+    if(isDType<std::int8_t>(dtype))   return Getter::template get<std::int8_t>();
+    if(isDType<std::int16_t>(dtype))  return Getter::template get<std::int16_t>();
+    if(isDType<std::int32_t>(dtype))  return Getter::template get<std::int32_t>();
+    if(isDType<std::int64_t>(dtype))  return Getter::template get<std::int64_t>();
+    if(isDType<std::uint8_t>(dtype))  return Getter::template get<std::uint8_t>();
+    if(isDType<std::uint16_t>(dtype)) return Getter::template get<std::uint16_t>();
+    if(isDType<std::uint32_t>(dtype)) return Getter::template get<std::uint32_t>();
+    if(isDType<std::uint64_t>(dtype)) return Getter::template get<std::uint64_t>();
+    if(isDType<float>(dtype))         return Getter::template get<float>();
+    if(isDType<double>(dtype))        return Getter::template get<double>();
+
+    return nullptr;
+}
+
+template <typename Getter>
+static inline typename Getter::Fcn getComplexDTypeFcn(const Pothos::DType& dtype)
+{
+    if(isDType<std::complex<float>>(dtype))  return Getter::template get<std::complex<float>>();
+    if(isDType<std::complex<double>>(dtype)) return Getter::template get<std::complex<double>>();
+
+    return nullptr;
+}
+
+}
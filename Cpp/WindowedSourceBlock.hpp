@@ -0,0 +1,154 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/BaseBlock.hpp"
+
+#include <Pothos/Exception.hpp>
+#include <Pothos/Framework.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace PothosNumPy
+{
+
+//
+// Common to the native sources that play an array from a file. Playback
+// can be limited to a window of the array, set by startIndex and count, and
+// repeat mode loops over just that window. Subclasses set the array's
+// length with setNumElements() and output from position() onwards.
+//
+
+class WindowedSourceBlock: public BaseBlock
+{
+    public:
+        WindowedSourceBlock(
+            const std::string& blockPath,
+            const bool repeat
+        ):
+            BaseBlock(blockPath),
+            _repeat(repeat),
+            _numElements(0),
+            _startIndex(0),
+            _count(0),
+            _pos(0)
+        {
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, repeat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, setRepeat));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, numElements));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, startIndex));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, setStartIndex));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, count));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, setCount));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, position));
+            this->registerCall(this, POTHOS_FCN_TUPLE(WindowedSourceBlock, seek));
+            this->registerProbe("position");
+        }
+
+        virtual ~WindowedSourceBlock() = default;
+
+        bool repeat() const
+        {
+            return _repeat;
+        }
+
+        void setRepeat(const bool repeat)
+        {
+            _repeat = repeat;
+        }
+
+        // Per channel
+        size_t numElements() const
+        {
+            return _numElements;
+        }
+
+        size_t startIndex() const
+        {
+            return _startIndex;
+        }
+
+        // Also moves playback to the start of the window.
+        void setStartIndex(const size_t startIndex)
+        {
+            if(startIndex > _numElements)
+            {
+                throw Pothos::InvalidArgumentException(
+                          "Start index "+std::to_string(startIndex)+" is past the end of the array",
+                          std::to_string(_numElements));
+            }
+
+            _startIndex = startIndex;
+            _pos = startIndex;
+        }
+
+        // 0 plays to the end of the array.
+        size_t count() const
+        {
+            return _count;
+        }
+
+        void setCount(const size_t count)
+        {
+            _count = count;
+            _pos = std::min(_pos, this->windowEnd());
+        }
+
+        // The index of the next sample to be output
+        size_t position() const
+        {
+            return _pos;
+        }
+
+        void seek(const size_t index)
+        {
+            if((index < _startIndex) || (index > this->windowEnd()))
+            {
+                throw Pothos::InvalidArgumentException(
+                          "Seek index "+std::to_string(index)+" is outside of the window",
+                          "["+std::to_string(_startIndex)+", "+std::to_string(this->windowEnd())+"]");
+            }
+
+            _pos = index;
+        }
+
+    protected:
+        void setNumElements(const size_t numElements)
+        {
+            _numElements = numElements;
+        }
+
+        // Loops back to the start of the window if repeating, and returns
+        // how many of the given number of elements are left in the window.
+        size_t windowElements(const size_t maxElements)
+        {
+            const auto windowEnd = this->windowEnd();
+            if((_pos == windowEnd) && _repeat) _pos = _startIndex;
+
+            return std::min(maxElements, windowEnd - _pos);
+        }
+
+        void advance(const size_t elems)
+        {
+            _pos += elems;
+        }
+
+    private:
+        bool _repeat;
+
+        size_t _numElements;
+        size_t _startIndex;
+        size_t _count;
+        size_t _pos;
+
+        // The window is clipped to the end of the array.
+        size_t windowEnd() const
+        {
+            const auto remaining = _numElements - _startIndex;
+            return _startIndex + ((_count > 0) ? std::min(_count, remaining) : remaining);
+        }
+};
+
+}
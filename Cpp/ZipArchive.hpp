@@ -0,0 +1,790 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "Cpp/AsyncFileWriter.hpp"
+#include "Cpp/ParallelDeflate.hpp"
+
+#include <Pothos/Exception.hpp>
+
+#include <Poco/File.h>
+#include <Poco/LocalDateTime.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace PothosNumPy
+{
+
+//
+// Minimal ZIP64 support for .npz files, which are ZIP archives with one
+// .npy file per key. New entries are streamed to the end of an archive
+// without touching the existing entries, which is what numpy.savez can't
+// do. Only the features numpy.load needs are supported: single-disk
+// archives with stored or deflated entries.
+//
+
+struct ZipEntry
+{
+    std::string name;
+    std::uint16_t method;
+    std::uint32_t crc32;
+    std::uint64_t compressedSize;
+    std::uint64_t uncompressedSize;
+    std::uint64_t localHeaderOffset;
+
+    // The entry's central directory record, written back as-is when the
+    // archive is updated
+    std::string centralDirectoryRecord;
+};
+
+struct ZipDirectory
+{
+    std::vector<ZipEntry> entries;
+
+    // New entries are written here, over the existing central directory.
+    std::uint64_t centralDirectoryOffset;
+};
+
+namespace detail
+{
+    static constexpr std::uint16_t ZipMethodStored = 0;
+    static constexpr std::uint16_t ZipMethodDeflated = 8;
+
+    static constexpr std::uint32_t ZipLocalHeaderSignature = 0x04034b50;
+    static constexpr std::uint32_t ZipCentralDirectorySignature = 0x02014b50;
+    static constexpr std::uint32_t ZipEndOfCentralDirectorySignature = 0x06054b50;
+    static constexpr std::uint32_t Zip64EndOfCentralDirectorySignature = 0x06064b50;
+    static constexpr std::uint32_t Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+
+    static constexpr std::uint16_t Zip64ExtraFieldID = 0x0001;
+
+    // Version 4.5 is the first to support ZIP64.
+    static constexpr std::uint16_t ZipVersion = 45;
+
+    static constexpr size_t ZipLocalHeaderSize = 30;
+    static constexpr size_t ZipCentralDirectoryRecordSize = 46;
+    static constexpr size_t ZipEndOfCentralDirectorySize = 22;
+    static constexpr size_t Zip64EndOfCentralDirectorySize = 56;
+    static constexpr size_t Zip64EndOfCentralDirectoryLocatorSize = 20;
+
+    // For compressed data read from the archive
+    static constexpr size_t ZipBufferSize = 1 << 16;
+
+    template <typename T>
+    static inline T getLE(const char* data)
+    {
+        T ret = 0;
+        for(size_t byte = 0; byte < sizeof(T); ++byte)
+        {
+            ret |= (T(static_cast<unsigned char>(data[byte])) << (8*byte));
+        }
+
+        return ret;
+    }
+
+    template <typename T>
+    static inline void putLE(std::string& data, const T value)
+    {
+        for(size_t byte = 0; byte < sizeof(T); ++byte)
+        {
+            data += char((value >> (8*byte)) & 0xFF);
+        }
+    }
+
+    template <typename T>
+    static inline void setLE(std::string& data, const size_t pos, const T value)
+    {
+        for(size_t byte = 0; byte < sizeof(T); ++byte)
+        {
+            data[pos+byte] = char((value >> (8*byte)) & 0xFF);
+        }
+    }
+
+    static inline std::string readZipBytes(
+        std::istream& stream,
+        const std::uint64_t offset,
+        const size_t size,
+        const std::string& filepath)
+    {
+        std::string ret(size, '\0');
+
+        stream.clear();
+        stream.seekg(offset);
+        stream.read(&ret[0], size);
+        if(!stream)
+        {
+            throw Pothos::DataFormatException("Truncated ZIP archive", filepath);
+        }
+
+        return ret;
+    }
+
+    // Names are flagged as UTF-8 if they aren't plain ASCII.
+    static inline std::uint16_t getZipFlags(const std::string& name)
+    {
+        const bool isASCII = std::all_of(
+            name.begin(),
+            name.end(),
+            [](const char c){return (0 == (c & 0x80));});
+
+        return isASCII ? 0 : 0x0800;
+    }
+
+    static inline void getZipDateTime(std::uint16_t* pDate, std::uint16_t* pTime)
+    {
+        const Poco::LocalDateTime now;
+
+        *pDate = std::uint16_t(((std::max(now.year(), 1980) - 1980) << 9) | (now.month() << 5) | now.day());
+        *pTime = std::uint16_t((now.hour() << 11) | (now.minute() << 5) | (now.second() / 2));
+    }
+
+    static inline ZipEntry parseZipCentralDirectoryRecord(
+        const std::string& directory,
+        const size_t pos,
+        const std::string& filepath)
+    {
+        if(((pos + ZipCentralDirectoryRecordSize) > directory.size()) ||
+           (ZipCentralDirectorySignature != getLE<std::uint32_t>(&directory[pos])))
+        {
+            throw Pothos::DataFormatException("Invalid ZIP central directory", filepath);
+        }
+
+        const char* record = &directory[pos];
+        const auto nameSize = getLE<std::uint16_t>(record+28);
+        const auto extraSize = getLE<std::uint16_t>(record+30);
+        const auto commentSize = getLE<std::uint16_t>(record+32);
+
+        const size_t recordSize = ZipCentralDirectoryRecordSize + nameSize + extraSize + commentSize;
+        if((pos + recordSize) > directory.size())
+        {
+            throw Pothos::DataFormatException("Invalid ZIP central directory", filepath);
+        }
+
+        ZipEntry entry;
+        entry.name = directory.substr(pos + ZipCentralDirectoryRecordSize, nameSize);
+        entry.method = getLE<std::uint16_t>(record+10);
+        entry.crc32 = getLE<std::uint32_t>(record+16);
+        entry.compressedSize = getLE<std::uint32_t>(record+20);
+        entry.uncompressedSize = getLE<std::uint32_t>(record+24);
+        entry.localHeaderOffset = getLE<std::uint32_t>(record+42);
+        entry.centralDirectoryRecord = directory.substr(pos, recordSize);
+
+        // Fields that don't fit in 32 bits are stored in the ZIP64 extra
+        // field, in this order, only if their 32-bit field is saturated.
+        const char* extra = record + ZipCentralDirectoryRecordSize + nameSize;
+        for(size_t extraPos = 0; (extraPos + 4) <= extraSize;)
+        {
+            const auto id = getLE<std::uint16_t>(extra+extraPos);
+            const auto size = getLE<std::uint16_t>(extra+extraPos+2);
+            extraPos += 4;
+
+            if(Zip64ExtraFieldID == id)
+            {
+                size_t fieldPos = extraPos;
+                for(auto* field: {&entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset})
+                {
+                    if((0xFFFFFFFF == *field) && ((fieldPos + 8) <= (extraPos + size)))
+                    {
+                        *field = getLE<std::uint64_t>(extra+fieldPos);
+                        fieldPos += 8;
+                    }
+                }
+            }
+
+            extraPos += size;
+        }
+
+        return entry;
+    }
+}
+
+//
+// Reading
+//
+
+static inline ZipDirectory readZipDirectory(
+    std::istream& stream,
+    const std::string& filepath)
+{
+    stream.clear();
+    stream.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = stream.tellg();
+
+    // The end of central directory record is followed by a comment of up
+    // to 64 KiB, so search backwards for its signature.
+    const size_t searchSize = size_t(std::min<std::uint64_t>(fileSize, detail::ZipEndOfCentralDirectorySize + 0xFFFF));
+    const auto tail = detail::readZipBytes(stream, fileSize - searchSize, searchSize, filepath);
+
+    size_t eocdPos = std::string::npos;
+    for(size_t pos = searchSize - std::min(searchSize, detail::ZipEndOfCentralDirectorySize) + 1; pos-- > 0;)
+    {
+        if(((pos + detail::ZipEndOfCentralDirectorySize) <= searchSize) &&
+           (detail::ZipEndOfCentralDirectorySignature == detail::getLE<std::uint32_t>(&tail[pos])))
+        {
+            eocdPos = pos;
+            break;
+        }
+    }
+    if(std::string::npos == eocdPos)
+    {
+        throw Pothos::DataFormatException("Not a ZIP archive", filepath);
+    }
+
+    const char* eocd = &tail[eocdPos];
+    if((0 != detail::getLE<std::uint16_t>(eocd+4)) || (0 != detail::getLE<std::uint16_t>(eocd+6)))
+    {
+        throw Pothos::DataFormatException("Multi-disk ZIP archives are not supported", filepath);
+    }
+
+    std::uint64_t numEntries = detail::getLE<std::uint16_t>(eocd+10);
+    std::uint64_t directorySize = detail::getLE<std::uint32_t>(eocd+12);
+    std::uint64_t directoryOffset = detail::getLE<std::uint32_t>(eocd+16);
+
+    if((0xFFFF == numEntries) || (0xFFFFFFFF == directorySize) || (0xFFFFFFFF == directoryOffset))
+    {
+        const std::uint64_t eocdOffset = fileSize - searchSize + eocdPos;
+        if(eocdOffset < detail::Zip64EndOfCentralDirectoryLocatorSize)
+        {
+            throw Pothos::DataFormatException("Invalid ZIP64 archive", filepath);
+        }
+
+        const auto locator = detail::readZipBytes(
+                                 stream,
+                                 eocdOffset - detail::Zip64EndOfCentralDirectoryLocatorSize,
+                                 detail::Zip64EndOfCentralDirectoryLocatorSize,
+                                 filepath);
+        if(detail::Zip64EndOfCentralDirectoryLocatorSignature != detail::getLE<std::uint32_t>(&locator[0]))
+        {
+            throw Pothos::DataFormatException("Invalid ZIP64 archive", filepath);
+        }
+
+        const auto zip64Eocd = detail::readZipBytes(
+                                   stream,
+                                   detail::getLE<std::uint64_t>(&locator[8]),
+                                   detail::Zip64EndOfCentralDirectorySize,
+                                   filepath);
+        if(detail::Zip64EndOfCentralDirectorySignature != detail::getLE<std::uint32_t>(&zip64Eocd[0]))
+        {
+            throw Pothos::DataFormatException("Invalid ZIP64 archive", filepath);
+        }
+
+        numEntries = detail::getLE<std::uint64_t>(&zip64Eocd[32]);
+        directorySize = detail::getLE<std::uint64_t>(&zip64Eocd[40]);
+        directoryOffset = detail::getLE<std::uint64_t>(&zip64Eocd[48]);
+    }
+
+    if((directoryOffset + directorySize) > fileSize)
+    {
+        throw Pothos::DataFormatException("Invalid ZIP central directory", filepath);
+    }
+
+    ZipDirectory directory;
+    directory.centralDirectoryOffset = directoryOffset;
+
+    const auto records = detail::readZipBytes(stream, directoryOffset, size_t(directorySize), filepath);
+    for(size_t pos = 0; directory.entries.size() < numEntries;)
+    {
+        directory.entries.emplace_back(detail::parseZipCentralDirectoryRecord(records, pos, filepath));
+        pos += directory.entries.back().centralDirectoryRecord.size();
+    }
+
+    return directory;
+}
+
+// The offset of the entry's data, after its local header
+static inline std::uint64_t getZipEntryDataOffset(
+    std::istream& stream,
+    const ZipEntry& entry,
+    const std::string& filepath)
+{
+    const auto header = detail::readZipBytes(stream, entry.localHeaderOffset, detail::ZipLocalHeaderSize, filepath);
+    if(detail::ZipLocalHeaderSignature != detail::getLE<std::uint32_t>(&header[0]))
+    {
+        throw Pothos::DataFormatException("Invalid ZIP local header for "+entry.name, filepath);
+    }
+
+    return entry.localHeaderOffset
+         + detail::ZipLocalHeaderSize
+         + detail::getLE<std::uint16_t>(&header[26])
+         + detail::getLE<std::uint16_t>(&header[28]);
+}
+
+// Reads an entry's contents, decompressing them as needed, so entries of
+// any size can be read in pieces. The CRC is checked once the whole entry
+// has been read, unless part of a stored entry was skipped without being
+// read.
+class ZipEntryStreamBuf: public std::streambuf
+{
+    public:
+        ZipEntryStreamBuf(
+            const std::string& filepath,
+            const ZipEntry& entry
+        ):
+            _filepath(filepath),
+            _entry(entry),
+            _compressedRemaining(entry.compressedSize),
+            _uncompressedRemaining(entry.uncompressedSize),
+            _crc(::crc32(0, Z_NULL, 0)),
+            _checkCRC(true),
+            _zstream(z_stream()),
+            _inBuffer(detail::ZipBufferSize),
+            _outBuffer(detail::ZipBufferSize)
+        {
+            if((detail::ZipMethodStored != entry.method) && (detail::ZipMethodDeflated != entry.method))
+            {
+                throw Pothos::DataFormatException("Unsupported ZIP compression method "+std::to_string(entry.method), filepath);
+            }
+
+            _stream.open(filepath, std::ios::in | std::ios::binary);
+            if(!_stream)
+            {
+                throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+            }
+            _stream.seekg(getZipEntryDataOffset(_stream, entry, filepath));
+
+            if((detail::ZipMethodDeflated == entry.method) && (Z_OK != inflateInit2(&_zstream, -MAX_WBITS)))
+            {
+                throw Pothos::RuntimeException("Failed to initialize zlib");
+            }
+        }
+
+        virtual ~ZipEntryStreamBuf()
+        {
+            if(detail::ZipMethodDeflated == _entry.method) inflateEnd(&_zstream);
+        }
+
+        // Stored entries are skipped by seeking, but deflated entries can
+        // only be skipped by decompressing everything in between.
+        void skip(std::uint64_t size)
+        {
+            const auto buffered = std::min<std::uint64_t>(size, this->egptr() - this->gptr());
+            this->setg(this->eback(), this->gptr() + buffered, this->egptr());
+            size -= buffered;
+
+            if((detail::ZipMethodStored == _entry.method) && (size > 0))
+            {
+                if(size > _uncompressedRemaining)
+                {
+                    throw Pothos::DataFormatException("Truncated ZIP entry "+_entry.name, _filepath);
+                }
+
+                _stream.seekg(std::streamoff(size), std::ios::cur);
+                _compressedRemaining -= size;
+                _uncompressedRemaining -= size;
+                _checkCRC = false;
+                return;
+            }
+
+            while(size > 0)
+            {
+                if(traits_type::eq_int_type(this->underflow(), traits_type::eof()))
+                {
+                    throw Pothos::DataFormatException("Truncated ZIP entry "+_entry.name, _filepath);
+                }
+
+                const auto numSkipped = std::min<std::uint64_t>(size, this->egptr() - this->gptr());
+                this->setg(this->eback(), this->gptr() + numSkipped, this->egptr());
+                size -= numSkipped;
+            }
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            if(this->gptr() < this->egptr()) return traits_type::to_int_type(*this->gptr());
+            if(0 == _uncompressedRemaining) return traits_type::eof();
+
+            const size_t outSize = size_t(std::min<std::uint64_t>(_outBuffer.size(), _uncompressedRemaining));
+            size_t numRead = 0;
+
+            if(detail::ZipMethodStored == _entry.method)
+            {
+                numRead = this->readCompressed(_outBuffer.data(), outSize);
+            }
+            else
+            {
+                _zstream.next_out = reinterpret_cast<Bytef*>(_outBuffer.data());
+                _zstream.avail_out = uInt(outSize);
+
+                while(_zstream.avail_out > 0)
+                {
+                    if((0 == _zstream.avail_in) && (_compressedRemaining > 0))
+                    {
+                        _zstream.next_in = reinterpret_cast<Bytef*>(_inBuffer.data());
+                        _zstream.avail_in = uInt(this->readCompressed(_inBuffer.data(), _inBuffer.size()));
+                    }
+
+                    const auto status = inflate(&_zstream, Z_NO_FLUSH);
+                    if((Z_STREAM_END == status) || (Z_BUF_ERROR == status)) break;
+                    if(Z_OK != status)
+                    {
+                        throw Pothos::DataFormatException("Failed to decompress "+_entry.name, _filepath);
+                    }
+                }
+
+                numRead = outSize - _zstream.avail_out;
+            }
+
+            if(numRead < outSize)
+            {
+                throw Pothos::DataFormatException("Truncated ZIP entry "+_entry.name, _filepath);
+            }
+
+            _crc = ::crc32(_crc, reinterpret_cast<const Bytef*>(_outBuffer.data()), uInt(numRead));
+            _uncompressedRemaining -= numRead;
+            if((0 == _uncompressedRemaining) && _checkCRC && (_crc != _entry.crc32))
+            {
+                throw Pothos::DataFormatException("CRC mismatch in "+_entry.name, _filepath);
+            }
+
+            this->setg(_outBuffer.data(), _outBuffer.data(), _outBuffer.data() + numRead);
+            return traits_type::to_int_type(*this->gptr());
+        }
+
+    private:
+        std::string _filepath;
+        ZipEntry _entry;
+        std::ifstream _stream;
+
+        std::uint64_t _compressedRemaining;
+        std::uint64_t _uncompressedRemaining;
+        uLong _crc;
+        bool _checkCRC;
+
+        z_stream _zstream;
+        std::vector<char> _inBuffer;
+        std::vector<char> _outBuffer;
+
+        size_t readCompressed(char* data, const size_t size)
+        {
+            const size_t readSize = size_t(std::min<std::uint64_t>(size, _compressedRemaining));
+            _stream.read(data, readSize);
+
+            const size_t numRead = size_t(_stream.gcount());
+            _compressedRemaining -= numRead;
+
+            return numRead;
+        }
+};
+
+//
+// Writing
+//
+
+class ZipArchiveWriter
+{
+    public:
+        // Opens an existing archive for adding entries, or creates a new one.
+        // The file is written on a background thread and synced as given.
+        explicit ZipArchiveWriter(
+            const std::string& filepath,
+            const FileSyncMode syncMode = FileSyncMode::OnClose,
+            const std::uint64_t syncInterval = 0
+        ):
+            _filepath(filepath),
+            _offset(0),
+            _inEntry(false),
+            _compress(false),
+            _prefixSize(0),
+            _localHeaderOffset(0),
+            _prefixOffset(0),
+            _dataCRC(0),
+            _dataSize(0)
+        {
+            const bool exists = Poco::File(filepath).exists();
+            if(exists)
+            {
+                std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+                if(!stream)
+                {
+                    throw Pothos::OpenFileException("Failed to open file for reading", filepath);
+                }
+
+                auto directory = readZipDirectory(stream, filepath);
+                _entries = std::move(directory.entries);
+                _offset = directory.centralDirectoryOffset;
+            }
+
+            _file.reset(new AsyncFileWriter(filepath, !exists, syncMode, syncInterval));
+            _file->seek(_offset);
+        }
+
+        virtual ~ZipArchiveWriter() = default;
+
+        const std::vector<ZipEntry>& entries() const
+        {
+            return _entries;
+        }
+
+        const AsyncFileWriter& file() const
+        {
+            return *_file;
+        }
+
+        // The entry's data is left in the file, but it won't be listed in
+        // the new central directory.
+        void removeEntry(const std::string& name)
+        {
+            _entries.erase(
+                std::remove_if(
+                    _entries.begin(),
+                    _entries.end(),
+                    [&name](const ZipEntry& entry){return (name == entry.name);}),
+                _entries.end());
+        }
+
+        // The first prefixSize bytes of the entry aren't known until the
+        // entry is finished, such as a header describing the data. They're
+        // stored uncompressed so they can be filled in place.
+        void beginEntry(
+            const std::string& name,
+            const bool compress,
+            const size_t prefixSize)
+        {
+            if(_inEntry) throw Pothos::AssertionViolationException("ZIP entry already in progress");
+            if(prefixSize > 0xFFFF) throw Pothos::InvalidArgumentException("ZIP entry prefix too large");
+
+            this->removeEntry(name);
+
+            _entry = ZipEntry();
+            _entry.name = name;
+            _entry.method = compress ? detail::ZipMethodDeflated : detail::ZipMethodStored;
+            _entry.localHeaderOffset = _offset;
+
+            _compress = compress;
+            _prefixSize = prefixSize;
+            _localHeaderOffset = _offset;
+            _dataCRC = ::crc32(0, Z_NULL, 0);
+            _dataSize = 0;
+
+            std::uint16_t date, time;
+            detail::getZipDateTime(&date, &time);
+
+            // The CRC and sizes are filled in by endEntry(). The sizes are
+            // always in the ZIP64 extra field, since they aren't known yet.
+            std::string header;
+            detail::putLE<std::uint32_t>(header, detail::ZipLocalHeaderSignature);
+            detail::putLE<std::uint16_t>(header, detail::ZipVersion);
+            detail::putLE<std::uint16_t>(header, detail::getZipFlags(name));
+            detail::putLE<std::uint16_t>(header, _entry.method);
+            detail::putLE<std::uint16_t>(header, time);
+            detail::putLE<std::uint16_t>(header, date);
+            detail::putLE<std::uint32_t>(header, 0);
+            detail::putLE<std::uint32_t>(header, 0xFFFFFFFF);
+            detail::putLE<std::uint32_t>(header, 0xFFFFFFFF);
+            detail::putLE<std::uint16_t>(header, std::uint16_t(name.size()));
+            detail::putLE<std::uint16_t>(header, 20);
+            header += name;
+            detail::putLE<std::uint16_t>(header, detail::Zip64ExtraFieldID);
+            detail::putLE<std::uint16_t>(header, 16);
+            detail::putLE<std::uint64_t>(header, 0);
+            detail::putLE<std::uint64_t>(header, 0);
+
+            // A deflate stream can start with a stored block, which holds the
+            // prefix uncompressed. It's not the final block, so the rest of
+            // the data follows as a regular deflate stream.
+            _prefixOffset = _offset + header.size();
+            if(_compress)
+            {
+                header += '\0';
+                detail::putLE<std::uint16_t>(header, std::uint16_t(prefixSize));
+                detail::putLE<std::uint16_t>(header, std::uint16_t(~prefixSize));
+                _prefixOffset += 5;
+            }
+            header.append(prefixSize, '\0');
+
+            this->writeBytes(header.data(), header.size());
+
+            if(_compress)
+            {
+                _deflater.reset(new ParallelDeflater(
+                    [this](const char* data, const size_t size){this->writeBytes(data, size);}));
+            }
+
+            _inEntry = true;
+        }
+
+        void write(const void* data, const size_t size)
+        {
+            if(!_inEntry) throw Pothos::AssertionViolationException("No ZIP entry in progress");
+
+            _dataSize += size;
+
+            // The deflater computes the CRC on its worker threads.
+            if(_compress) _deflater->write(data, size);
+            else
+            {
+                _dataCRC = ::crc32(_dataCRC, reinterpret_cast<const Bytef*>(data), uInt(size));
+                this->writeBytes(data, size);
+            }
+        }
+
+        void endEntry(const std::string& prefix)
+        {
+            if(!_inEntry) throw Pothos::AssertionViolationException("No ZIP entry in progress");
+            if(prefix.size() != _prefixSize) throw Pothos::InvalidArgumentException("Invalid ZIP entry prefix size");
+
+            if(_compress)
+            {
+                _deflater->finish();
+                _dataCRC = _deflater->crc();
+                _deflater.reset();
+            }
+            _inEntry = false;
+
+            const auto endOffset = _offset;
+            const auto prefixCRC = ::crc32(::crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(prefix.data()), uInt(prefix.size()));
+
+            _entry.crc32 = std::uint32_t(crc32_combine64(prefixCRC, _dataCRC, z_off64_t(_dataSize)));
+            _entry.uncompressedSize = _prefixSize + _dataSize;
+            _entry.compressedSize = endOffset - (_localHeaderOffset + detail::ZipLocalHeaderSize + _entry.name.size() + 20);
+
+            // Fill in the prefix, CRC, and sizes.
+            std::string fields;
+            detail::putLE<std::uint32_t>(fields, _entry.crc32);
+
+            std::string sizes;
+            detail::putLE<std::uint64_t>(sizes, _entry.uncompressedSize);
+            detail::putLE<std::uint64_t>(sizes, _entry.compressedSize);
+
+            this->writeAt(_prefixOffset, prefix);
+            this->writeAt(_localHeaderOffset + 14, fields);
+            this->writeAt(_localHeaderOffset + detail::ZipLocalHeaderSize + _entry.name.size() + 4, sizes);
+
+            _entry.centralDirectoryRecord = this->makeCentralDirectoryRecord(_entry);
+            _entries.emplace_back(_entry);
+        }
+
+        // Write the central directory, after which no more entries can be
+        // added.
+        void close()
+        {
+            if(_inEntry) throw Pothos::AssertionViolationException("ZIP entry still in progress");
+
+            const auto directoryOffset = _offset;
+            for(const auto& entry: _entries)
+            {
+                this->writeBytes(entry.centralDirectoryRecord.data(), entry.centralDirectoryRecord.size());
+            }
+            const std::uint64_t directorySize = _offset - directoryOffset;
+            const std::uint64_t numEntries = _entries.size();
+
+            const bool needsZip64 = (numEntries >= 0xFFFF) ||
+                                    (directorySize >= 0xFFFFFFFF) ||
+                                    (directoryOffset >= 0xFFFFFFFF);
+
+            std::string end;
+            if(needsZip64)
+            {
+                const auto zip64EocdOffset = _offset;
+
+                detail::putLE<std::uint32_t>(end, detail::Zip64EndOfCentralDirectorySignature);
+                detail::putLE<std::uint64_t>(end, detail::Zip64EndOfCentralDirectorySize - 12);
+                detail::putLE<std::uint16_t>(end, detail::ZipVersion);
+                detail::putLE<std::uint16_t>(end, detail::ZipVersion);
+                detail::putLE<std::uint32_t>(end, 0);
+                detail::putLE<std::uint32_t>(end, 0);
+                detail::putLE<std::uint64_t>(end, numEntries);
+                detail::putLE<std::uint64_t>(end, numEntries);
+                detail::putLE<std::uint64_t>(end, directorySize);
+                detail::putLE<std::uint64_t>(end, directoryOffset);
+
+                detail::putLE<std::uint32_t>(end, detail::Zip64EndOfCentralDirectoryLocatorSignature);
+                detail::putLE<std::uint32_t>(end, 0);
+                detail::putLE<std::uint64_t>(end, zip64EocdOffset);
+                detail::putLE<std::uint32_t>(end, 1);
+            }
+
+            detail::putLE<std::uint32_t>(end, detail::ZipEndOfCentralDirectorySignature);
+            detail::putLE<std::uint16_t>(end, 0);
+            detail::putLE<std::uint16_t>(end, 0);
+            detail::putLE<std::uint16_t>(end, std::uint16_t(std::min<std::uint64_t>(numEntries, 0xFFFF)));
+            detail::putLE<std::uint16_t>(end, std::uint16_t(std::min<std::uint64_t>(numEntries, 0xFFFF)));
+            detail::putLE<std::uint32_t>(end, std::uint32_t(std::min<std::uint64_t>(directorySize, 0xFFFFFFFF)));
+            detail::putLE<std::uint32_t>(end, std::uint32_t(std::min<std::uint64_t>(directoryOffset, 0xFFFFFFFF)));
+            detail::putLE<std::uint16_t>(end, 0);
+            this->writeBytes(end.data(), end.size());
+
+            _file->close();
+
+            // The new contents may be shorter than the old central directory.
+            Poco::File(_filepath).setSize(_offset);
+        }
+
+    private:
+        std::string _filepath;
+        std::unique_ptr<AsyncFileWriter> _file;
+        std::vector<ZipEntry> _entries;
+
+        // Where the next bytes are written
+        std::uint64_t _offset;
+
+        // The entry in progress
+        ZipEntry _entry;
+        bool _inEntry;
+        bool _compress;
+        size_t _prefixSize;
+        std::uint64_t _localHeaderOffset;
+        std::uint64_t _prefixOffset;
+        uLong _dataCRC;
+        std::uint64_t _dataSize;
+
+        std::unique_ptr<ParallelDeflater> _deflater;
+
+        void writeBytes(const void* data, const size_t size)
+        {
+            _file->write(data, size);
+            _offset += size;
+        }
+
+        void writeAt(const std::uint64_t offset, const std::string& data)
+        {
+            _file->writeAt(offset, data.data(), data.size());
+        }
+
+        std::string makeCentralDirectoryRecord(const ZipEntry& entry) const
+        {
+            std::uint16_t date, time;
+            detail::getZipDateTime(&date, &time);
+
+            std::string record;
+            detail::putLE<std::uint32_t>(record, detail::ZipCentralDirectorySignature);
+            detail::putLE<std::uint16_t>(record, detail::ZipVersion);
+            detail::putLE<std::uint16_t>(record, detail::ZipVersion);
+            detail::putLE<std::uint16_t>(record, detail::getZipFlags(entry.name));
+            detail::putLE<std::uint16_t>(record, entry.method);
+            detail::putLE<std::uint16_t>(record, time);
+            detail::putLE<std::uint16_t>(record, date);
+            detail::putLE<std::uint32_t>(record, entry.crc32);
+            detail::putLE<std::uint32_t>(record, 0xFFFFFFFF);
+            detail::putLE<std::uint32_t>(record, 0xFFFFFFFF);
+            detail::putLE<std::uint16_t>(record, std::uint16_t(entry.name.size()));
+            detail::putLE<std::uint16_t>(record, 28);
+            detail::putLE<std::uint16_t>(record, 0);
+            detail::putLE<std::uint16_t>(record, 0);
+            detail::putLE<std::uint16_t>(record, 0);
+            detail::putLE<std::uint32_t>(record, 0);
+            detail::putLE<std::uint32_t>(record, 0xFFFFFFFF);
+            record += entry.name;
+            detail::putLE<std::uint16_t>(record, detail::Zip64ExtraFieldID);
+            detail::putLE<std::uint16_t>(record, 24);
+            detail::putLE<std::uint64_t>(record, entry.uncompressedSize);
+            detail::putLE<std::uint64_t>(record, entry.compressedSize);
+            detail::putLE<std::uint64_t>(record, entry.localHeaderOffset);
+
+            return record;
+        }
+};
+
+}
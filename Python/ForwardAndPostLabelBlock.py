@@ -32,19 +32,23 @@ class ForwardAndPostLabelBlock(BaseBlock):
         assert(self.numpyOutputDType is not None)
 
         elems = self.input(0).elements()
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         buf = self.input(0).takeBuffer()
         numpyRet = None
 
-        if self.useDType:
-            numpyRet = self.func(buf, *self.funcArgs, dtype=self.numpyInputDType)
-        else:
-            numpyRet = self.func(buf, *self.funcArgs)
+        with self.funcTimer():
+            if self.useDType:
+                numpyRet = self.func(buf, *self.funcArgs, dtype=self.numpyInputDType)
+            else:
+                numpyRet = self.func(buf, *self.funcArgs)
 
         self.processAndPostBuffer(numpyRet, buf)
 
+        # The input buffer is forwarded as-is, so nothing is copied.
+        self.countElements(len(buf), len(buf))
+
     def processAndPostBuffer(self, numpyRet, buf):
         if self.findIndexFunc:
             index = self.findIndexFunc(buf)
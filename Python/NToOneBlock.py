@@ -48,45 +48,85 @@ class NToOneBlock(BaseBlock):
 
     def workWithPostBuffer(self):
         elems = self.workInfo().minAllInElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         N = min(elems, len(self.output(0).buffer()))
-
-        # This creates a 2D ndarray containing the array subsets we're interested
-        # in. This points to the input buffers themselves without copying memory.
-        allArrs = numpy.array([buf.buffer()[:N].view() for buf in self.inputs()], dtype=self.numpyInputDType)
+        with self.copyTimer():
+            allArrs = self.getInputArrays(N)
         out = None
 
-        if self.callReduce:
-            out = functools.reduce(self.func, allArrs, *self.funcArgs)
-        else:
-            out = self.func(allArrs, *self.funcArgs, **self.funcKWargs)
+        with self.funcTimer():
+            if self.callReduce:
+                out = functools.reduce(self.func, allArrs, *self.funcArgs)
+            else:
+                out = self.func(allArrs, *self.funcArgs, **self.funcKWargs)
 
         if (out is not None) and (len(out) > 0):
             for port in self.inputs():
                 port.consume(N)
             self.output(0).postBuffer(out)
+            self.countElements(N, len(out))
 
     def workWithGivenOutputBuffer(self):
         elems = self.workInfo().minAllElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
-        # This creates a 2D ndarray containing the array subsets we're interested
-        # in. This points to the input buffers themselves without copying memory.
-        allArrs = numpy.array([buf.buffer()[:elems].view() for buf in self.inputs()], dtype=self.numpyInputDType)
         out0 = self.output(0).buffer()
+
+        if self.callReduce and self.supportsOut:
+            self.reduceInPlace(out0[:elems])
+
+            for port in self.inputs():
+                port.consume(elems)
+            self.output(0).produce(elems)
+            self.countElements(elems, elems)
+            return
+
+        with self.copyTimer():
+            allArrs = self.getInputArrays(elems)
         out = None
 
-        if self.callReduce:
-            out = functools.reduce(self.func, allArrs, *self.funcArgs)
-        else:
-            out = self.func(allArrs, *self.funcArgs, **self.funcKWargs)
+        with self.funcTimer():
+            if self.callReduce:
+                out = functools.reduce(self.func, allArrs, *self.funcArgs)
+            else:
+                out = self.func(allArrs, *self.funcArgs, **self.funcKWargs)
 
         if (out is not None) and (len(out) > 0):
             for port in self.inputs():
                 port.consume(elems)
 
-            out0[:elems] = out
+            with self.copyTimer():
+                out0[:elems] = out
             self.output(0).produce(elems)
+            self.countElements(elems, elems)
+
+    def getInputArrays(self, N):
+        inputArrs = [port.buffer()[:N] for port in self.inputs()]
+
+        # Reducing only needs each input individually, so these can point to
+        # the input buffers themselves. Otherwise, the function expects a 2D
+        # array, which requires a copy.
+        if self.callReduce:
+            return inputArrs
+        else:
+            return numpy.array(inputArrs, dtype=self.numpyInputDType)
+
+    # Accumulate into the output buffer in place, which reads each input once
+    # and doesn't allocate any intermediate arrays.
+    def reduceInPlace(self, out):
+        inputArrs = self.getInputArrays(len(out))
+
+        if len(inputArrs) == 1:
+            with self.copyTimer():
+                out[:] = inputArrs[0]
+            return
+
+        # Unsafe casting matches the assignment into the output buffer in
+        # workWithGivenOutputBuffer.
+        with self.funcTimer():
+            self.func(inputArrs[0], inputArrs[1], out=out, casting="unsafe", **self.funcKWargs)
+            for arr in inputArrs[2:]:
+                self.func(out, arr, out=out, casting="unsafe", **self.funcKWargs)
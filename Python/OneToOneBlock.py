@@ -30,19 +30,24 @@ class OneToOneBlock(BaseBlock):
 
     def workWithPostBuffer(self):
         elems = self.workInfo().minAllInElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         in0 = self.input(0).buffer()
-        out = self.func(in0, *self.funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+
+        with self.funcTimer():
+            ret = self.func(in0, *self.funcArgs, **self.funcKWargs)
+        with self.copyTimer():
+            out = ret.astype(self.numpyOutputDType, copy=False)
 
         if (out is not None) and (len(out) > 0):
             self.input(0).consume(elems)
             self.output(0).postBuffer(out)
+            self.countElements(elems, len(out))
 
     def workWithGivenOutputBuffer(self):
         elems = self.workInfo().minAllInElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         in0 = self.input(0).buffer()
@@ -50,9 +55,24 @@ class OneToOneBlock(BaseBlock):
         N = min(len(in0), len(out0))
         out = None
 
-        out = self.func(in0[:N], *self.funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+        if self.supportsOut:
+            # Unsafe casting matches what astype() does below.
+            with self.funcTimer():
+                self.func(in0[:N], *self.funcArgs, out=out0[:N], casting="unsafe", **self.funcKWargs)
+
+            self.input(0).consume(N)
+            self.output(0).produce(N)
+            self.countElements(N, N)
+            return
+
+        with self.funcTimer():
+            ret = self.func(in0[:N], *self.funcArgs, **self.funcKWargs)
+        with self.copyTimer():
+            out = ret.astype(self.numpyOutputDType, copy=False)
 
         if (out is not None) and (len(out) > 0):
-            out0[:N] = out
+            with self.copyTimer():
+                out0[:N] = out
             self.input(0).consume(N)
             self.output(0).produce(N)
+            self.countElements(N, N)
@@ -27,20 +27,31 @@ class SingleOutputSource(BaseBlock):
             self.workWithGivenOutputBuffer()
 
     def workWithPostBuffer(self):
-        out = self.func(*self.funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+        with self.funcTimer():
+            ret = self.func(*self.funcArgs, **self.funcKWargs)
+        with self.copyTimer():
+            out = ret.astype(self.numpyOutputDType, copy=False)
+
         self.output(0).postBuffer(out)
+        self.countWork(len(out))
+        self.countElements(0, len(out))
 
     def workWithGivenOutputBuffer(self):
         elems = len(self.output(0).buffer())
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         funcArgs = ([elems] + self.funcArgs) if self.useShape else self.funcArgs
         funcArgs = funcArgs + [elems] if self.sizeParam else funcArgs
 
         out0 = self.output(0).buffer()
-        out0[:elems] = self.func(*funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+        with self.funcTimer():
+            ret = self.func(*funcArgs, **self.funcKWargs)
+        with self.copyTimer():
+            out0[:elems] = ret.astype(self.numpyOutputDType, copy=False)
+
         self.output(0).produce(elems)
+        self.countElements(0, elems)
 
 class FixedSingleOutputSource(SingleOutputSource):
     def __init__(self, blockPath, func, dtype, dtypeArgs, repeat, funcArgs, funcKWargs, *args, **kwargs):
@@ -64,3 +75,7 @@ class FixedSingleOutputSource(SingleOutputSource):
                 if len(self.output(0).buffer()) > 0:
                     self.workWithGivenOutputBuffer()
                     self.__workCalled = True
+                else:
+                    self.countWork(0)
+        else:
+            self.countWork(0)
@@ -3,11 +3,18 @@
 
 import Pothos
 from . import Random
+from .NToOneBlock import NToOneBlock
+from .OneToOneBlock import OneToOneBlock
+from .TwoToOneBlock import TwoToOneBlock
 
+import functools
 import numpy
 
 import os
 
+# The byte orders accepted by /numpy/fromfile and /numpy/tofile
+RawByteOrders = dict(native="=", little="<", big=">")
+
 #
 # Checking inputs
 #
@@ -34,6 +41,44 @@ def checkNpyContents(filepath, expectedValues):
     npyContents = numpy.load(filepath)
     checkArrayContents(expectedValues, npyContents)
 
+def checkNpyChannelContents(filepath, chan, expectedValues):
+    if not os.path.exists(filepath):
+        raise RuntimeError("Invalid filepath: {0}".format(filepath))
+
+    npyContents = numpy.load(filepath)
+    if 2 != len(npyContents.shape):
+        raise RuntimeError("Expected a 2D array. Actual shape {0}".format(npyContents.shape))
+
+    checkArrayContents(expectedValues, npyContents[chan])
+
+def checkNpzChannelContents(filepath, key, chan, expectedValues):
+    if not os.path.exists(filepath):
+        raise RuntimeError("Invalid filepath: {0}".format(filepath))
+
+    npzContents = numpy.load(filepath)[key]
+    if 2 != len(npzContents.shape):
+        raise RuntimeError("Expected a 2D array. Actual shape {0}".format(npzContents.shape))
+
+    checkArrayContents(expectedValues, npzContents[chan])
+
+def checkTextChannelContents(filepath, delimiter, chan, expectedValues):
+    if not os.path.exists(filepath):
+        raise RuntimeError("Invalid filepath: {0}".format(filepath))
+
+    textContents = numpy.loadtxt(filepath, dtype=expectedValues.dtype, delimiter=(delimiter if delimiter.strip() else None), ndmin=2)
+    checkArrayContents(expectedValues, textContents[:,chan])
+
+def checkAppendedNpyContents(filepath, originalValues, appendedValues):
+    checkNpyContents(filepath, numpy.concatenate([originalValues, appendedValues]))
+
+def checkAppendedRawContents(filepath, byteOrder, originalValues, appendedValues):
+    if not os.path.exists(filepath):
+        raise RuntimeError("Invalid filepath: {0}".format(filepath))
+
+    expectedValues = numpy.concatenate([originalValues, appendedValues])
+    rawContents = numpy.fromfile(filepath, dtype=expectedValues.dtype.newbyteorder(RawByteOrders[byteOrder]))
+    checkArrayContents(expectedValues, rawContents.astype(expectedValues.dtype))
+
 def checkNpzContents(filepath, expectedValues):
     if not os.path.exists(filepath):
         raise RuntimeError("Invalid filepath: {0}".format(filepath))
@@ -52,6 +97,17 @@ def checkNpzContents(filepath, expectedValues):
     for key in expectedKeys:
         checkArrayContents(expectedValues[key], npzContents[key])
 
+# appendedValues has one array per channel.
+def checkAppendedNpzContents(filepath, originalValues, key, appendedValues):
+    appendedValues = numpy.stack(appendedValues)
+    if 1 == len(originalValues[key].shape):
+        appendedValues = appendedValues[0]
+
+    expectedValues = dict(originalValues)
+    expectedValues[key] = numpy.concatenate([originalValues[key], appendedValues], axis=-1)
+
+    checkNpzContents(filepath, expectedValues)
+
 #
 # Generating outputs
 #
@@ -93,6 +149,13 @@ def generate1DNpyFile(filepath, dtype):
     # Return values for validation
     return values
 
+def generateLong1DNpyFile(filepath, dtype, arrLength):
+    values = generate1DRandomValues(dtype, arrLength)
+    numpy.save(filepath, values)
+
+    # Return values for validation
+    return values
+
 def generate2DNpyFile(filepath, dtype):
     values = generate2DRandomValues(dtype, 4, 256)
     numpy.save(filepath, values)
@@ -100,6 +163,63 @@ def generate2DNpyFile(filepath, dtype):
     # Return values for validation
     return values
 
+# Fortran order is used for every other file, so files that must be copied
+# are mixed with files that can be played in place.
+def generate2DNpyPlaylist(filepaths, dtype):
+    values = [generateFortranOrder2DNpyFile(filepath, dtype) if (index % 2) else generate2DNpyFile(filepath, dtype)
+              for index, filepath in enumerate(filepaths)]
+
+    # Return values for validation
+    return numpy.concatenate(values, axis=1)
+
+# Like a streaming capture that was interrupted before its header was
+# updated: the header's shape is (0,), and a partial sample follows the data.
+def generateInterrupted1DNpyFile(filepath, dtype):
+    values = generate1DRandomValues(dtype, 256)
+    with open(filepath, "wb") as f:
+        header = dict(descr=numpy.lib.format.dtype_to_descr(values.dtype), fortran_order=False, shape=(0,))
+        numpy.lib.format.write_array_header_1_0(f, header)
+        values.tofile(f)
+        f.write(b"\xa5" * (values.dtype.itemsize // 2))
+
+    # Return values for validation
+    return values
+
+def generateBigEndian1DNpyFile(filepath, dtype):
+    values = generate1DRandomValues(dtype, 256)
+    numpy.save(filepath, values.astype(values.dtype.newbyteorder(">")))
+
+    # Return values for validation
+    return values
+
+def generateFortranOrder2DNpyFile(filepath, dtype):
+    values = generate2DRandomValues(dtype, 4, 256)
+    numpy.save(filepath, numpy.asfortranarray(values))
+
+    # Return values for validation
+    return values
+
+# Each channel is written as a column, after a one-line header.
+def generate2DTextFile(filepath, dtype, delimiter):
+    values = generate2DRandomValues(dtype, 4, 256)
+    delimiter = delimiter if delimiter else " "
+    fmt = "%.18e" if numpy.issubdtype(values.dtype, numpy.floating) else "%d"
+    header = delimiter.join("chan{0}".format(chan) for chan in range(len(values)))
+    numpy.savetxt(filepath, values.T, fmt=fmt, delimiter=delimiter, header=header, comments="")
+
+    # Return values for validation
+    return values
+
+# Written after offset bytes of padding
+def generate1DRawFile(filepath, dtype, byteOrder, offset):
+    values = generate1DRandomValues(dtype, 256)
+    with open(filepath, "wb") as f:
+        f.write(b"\xa5" * offset)
+        values.astype(values.dtype.newbyteorder(RawByteOrders[byteOrder])).tofile(f)
+
+    # Return values for validation
+    return values
+
 def generateNpzFile(filepath, compressed):
     values = dict()
     keys = [
@@ -118,3 +238,40 @@ def generateNpzFile(filepath, compressed):
 
     # Return values for validation
     return values
+
+#
+# Native block validation
+#
+
+# Native blocks should match NumPy's output for the given inputs, converted
+# to the block's output type.
+def applyNumPyFunc(funcName, inputs, dtype):
+    return getattr(numpy, funcName)(*inputs).astype(Pothos.Buffer.dtype_to_numpy(dtype))
+
+# For N-to-1 blocks, which reduce their inputs with the function
+def reduceNumPyFunc(funcName, inputs, dtype):
+    return functools.reduce(getattr(numpy, funcName), inputs).astype(Pothos.Buffer.dtype_to_numpy(dtype))
+
+# For /numpy/expr, which names its inputs in0, in1, etc. An expression
+# without any inputs evaluates to a scalar, which the block outputs for
+# every input element.
+def evalNumPyExpression(expression, inputs, dtype):
+    namespace = dict(vars(numpy))
+    namespace.update({"in{0}".format(i): arr for i,arr in enumerate(inputs)})
+
+    result = eval(expression, {"__builtins__": dict()}, namespace)
+    return numpy.broadcast_to(result, inputs[0].shape).astype(Pothos.Buffer.dtype_to_numpy(dtype))
+
+# Factories use the native implementation of every ufunc block, so the Python
+# blocks' out= path is tested by building them directly.
+def makePythonUfuncBlock(funcName, inputDType, outputDType, nchans):
+    blockPath = "/numpy/" + funcName
+    func = getattr(numpy, funcName)
+    dtypeArgs = dict(supportAll=True)
+
+    if nchans == 1:
+        return OneToOneBlock(blockPath, func, inputDType, outputDType, dtypeArgs, dtypeArgs, list(), dict(), supportsOut=True)
+    elif nchans == 2:
+        return TwoToOneBlock(blockPath, func, inputDType, outputDType, dtypeArgs, dtypeArgs, list(), dict(), supportsOut=True)
+    else:
+        return NToOneBlock(blockPath, func, inputDType, outputDType, dtypeArgs, dtypeArgs, nchans, list(), dict(), supportsOut=True)
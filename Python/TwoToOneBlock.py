@@ -31,7 +31,7 @@ class TwoToOneBlock(BaseBlock):
 
     def workWithPostBuffer(self):
         elems = self.workInfo().minAllInElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         in0 = self.input(0).buffer()
@@ -41,18 +41,23 @@ class TwoToOneBlock(BaseBlock):
         out = None
 
         if self.useDType:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
+            with self.funcTimer():
+                out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
         else:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs).astype(self.numpyOutputDType)
+            with self.funcTimer():
+                ret = self.func(in0[:N], in1[:N], *self.funcArgs)
+            with self.copyTimer():
+                out = ret.astype(self.numpyOutputDType)
 
         if (out is not None) and (len(out) > 0):
             self.input(0).consume(elems)
             self.input(1).consume(elems)
             self.output(0).postBuffer(out)
+            self.countElements(elems, len(out))
 
     def workWithGivenOutputBuffer(self):
         elems = self.workInfo().minAllElements
-        if 0 == elems:
+        if not self.countWork(elems):
             return
 
         in0 = self.input(0).buffer()
@@ -62,14 +67,31 @@ class TwoToOneBlock(BaseBlock):
         N = min(len(in0), len(in1), len(out0))
         out = None
 
-        if self.useDType:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
-        else:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs)
+        if self.supportsOut:
+            # Unsafe casting matches the assignment into out0 below.
+            with self.funcTimer():
+                if self.useDType:
+                    self.func(in0[:N], in1[:N], *self.funcArgs, out=out0[:N], casting="unsafe", dtype=self.numpyInputDType)
+                else:
+                    self.func(in0[:N], in1[:N], *self.funcArgs, out=out0[:N], casting="unsafe")
+
+            self.input(0).consume(N)
+            self.input(1).consume(N)
+            self.output(0).produce(N)
+            self.countElements(N, N)
+            return
+
+        with self.funcTimer():
+            if self.useDType:
+                out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
+            else:
+                out = self.func(in0[:N], in1[:N], *self.funcArgs)
 
         if (out is not None) and (len(out) > 0):
-            out0[:N] = out
+            with self.copyTimer():
+                out0[:N] = out
 
             self.input(0).consume(N)
             self.input(1).consume(N)
             self.output(0).produce(N)
+            self.countElements(N, N)
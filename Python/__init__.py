@@ -2,9 +2,6 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from .BlockEntryPoints import *
-from .FFT import *
-from .FileSink import *
-from .FileSource import *
 from .Random import *
 from .RegisteredCallHelpers import *
 from .Utility import *
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Longer than one evaluation chunk, and not a multiple of it
+static constexpr size_t bufferLen = 1500;
+
+static constexpr size_t nchans = 3;
+
+static void testExpression(
+    const Pothos::DType& dtype,
+    const std::string& expression)
+{
+    std::cout << " * Testing \"" << expression << "\" (" << dtype.name() << ")..." << std::endl;
+
+    auto block = Pothos::BlockRegistry::make("/numpy/expr", dtype, nchans, expression);
+    POTHOS_TEST_EQUAL(expression, block.call<std::string>("expression"));
+
+    std::vector<Pothos::BufferChunk> inputs;
+    std::vector<Pothos::Proxy> feeders;
+    auto sink = Pothos::BlockRegistry::make("/blocks/collector_sink", dtype);
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            inputs.emplace_back(NPTests::getRandomInputs(dtype.name(), bufferLen));
+
+            feeders.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", dtype));
+            feeders.back().call("feedBuffer", inputs.back());
+
+            topology.connect(feeders.back(), 0, block, chan);
+        }
+        topology.connect(block, 0, sink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    NPTests::testBufferChunk(
+        testFuncs.call<Pothos::BufferChunk>("evalNumPyExpression", expression, inputs, dtype),
+        sink.call<Pothos::BufferChunk>("getBuffer"));
+}
+
+static void testExpressions(
+    const Pothos::DType& dtype,
+    const std::vector<std::string>& typeSpecificExpressions)
+{
+    static const std::vector<std::string> commonExpressions =
+    {
+        "in0*in1 + in2",
+        "(in0 - in1) / (in2 + 1) * 0.5",
+        "in0**2 - -in1**2 + in2**0.5",
+        "sqrt(in0) + exp(-in1) * log(in2 + 1)",
+        "power(in0, 2) + sin(in1)*cos(in2) + pi",
+        "in1",
+        "2*e + 3",
+    };
+
+    for(const auto& expression: commonExpressions) testExpression(dtype, expression);
+    for(const auto& expression: typeSpecificExpressions) testExpression(dtype, expression);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_expr_block)
+{
+    const std::vector<std::string> floatExpressions =
+    {
+        "maximum(in0, in1) - abs(in2 - 1) + floor(in0)",
+        "arctan2(in0, in1) + hypot(in1, in2)",
+    };
+    const std::vector<std::string> complexExpressions =
+    {
+        "conj(in0)*2j + in1",
+    };
+
+    testExpressions("float32", floatExpressions);
+    testExpressions("float64", floatExpressions);
+    testExpressions("complex_float32", complexExpressions);
+    testExpressions("complex_float64", complexExpressions);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_expr_block_errors)
+{
+    const std::vector<std::string> invalidExpressions =
+    {
+        "in0 + in3",
+        "in0 +",
+        "(in0 * in1",
+        "foo(in0)",
+        "in0 $ in1",
+        "1j + in0",
+    };
+
+    for(const auto& expression: invalidExpressions)
+    {
+        std::cout << " * Testing \"" << expression << "\"..." << std::endl;
+        POTHOS_TEST_THROWS(
+            Pothos::BlockRegistry::make("/numpy/expr", "float64", nchans, expression),
+            Pothos::Exception);
+    }
+
+    auto block = Pothos::BlockRegistry::make("/numpy/expr", "float64", nchans, "in0");
+    POTHOS_TEST_THROWS(
+        block.call("setExpression", "in0 +"),
+        Pothos::Exception);
+    POTHOS_TEST_EQUAL("in0", block.call<std::string>("expression"));
+}
@@ -13,6 +13,7 @@
 #include <complex>
 #include <iostream>
 #include <string>
+#include <vector>
 
 //
 // Parameters
@@ -337,9 +338,7 @@ static void testOutputPortType(const Pothos::Proxy& block)
 {
     static const Pothos::DType dtype(typeid(T));
 
-    const auto outputPortDType = block.call("output", 0)
-                                      .get("_port")
-                                      .call<Pothos::DType>("dtype");
+    const auto outputPortDType = block.call<std::vector<Pothos::PortInfo>>("outputPortInfo")[0].dtype;
     POTHOS_TEST_EQUAL(
         dtype.name(),
         outputPortDType.name());
@@ -548,6 +547,62 @@ static void testHFFT()
         NPTests::stdVectorToBufferChunk(testParams.revOutputs));
 }
 
+// Every complete frame in the input buffer should be transformed in a
+// single work() call.
+template <typename T>
+static void testBatchedFFT()
+{
+    constexpr size_t numFrames = 8;
+
+    const std::string blockRegistryPath = "/numpy/fft/fft";
+
+    const auto testParams = getFFTTestParams<T, T>();
+    const size_t numBins = testParams.inputs.size();
+
+    Pothos::DType dtype(typeid(T));
+    std::cout << "Testing " << blockRegistryPath << " with " << numFrames
+              << " frames of " << dtype.toString() << std::endl;
+
+    std::vector<T> inputs;
+    std::vector<T> outputs;
+    for(size_t frame = 0; frame < numFrames; ++frame)
+    {
+        inputs.insert(inputs.end(), testParams.inputs.begin(), testParams.inputs.end());
+        outputs.insert(outputs.end(), testParams.outputs.begin(), testParams.outputs.end());
+    }
+
+    auto feeder = Pothos::BlockRegistry::make(
+                      "/blocks/feeder_source",
+                      dtype);
+    auto fftBlock = Pothos::BlockRegistry::make(
+                        blockRegistryPath,
+                        dtype,
+                        numBins);
+    auto collector = Pothos::BlockRegistry::make(
+                         "/blocks/collector_sink",
+                         dtype);
+
+    feeder.call(
+        "feedBuffer",
+        NPTests::stdVectorToBufferChunk(inputs));
+
+    {
+        Pothos::Topology topology;
+        topology.connect(feeder, 0, fftBlock, 0);
+        topology.connect(fftBlock, 0, collector, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    NPTests::testBufferChunk(
+        collector.call("getBuffer"),
+        NPTests::stdVectorToBufferChunk(outputs));
+
+    const auto workCalls = fftBlock.call<size_t>("workCalls");
+    const auto zeroElementReturns = fftBlock.call<size_t>("zeroElementReturns");
+    POTHOS_TEST_TRUE((workCalls - zeroElementReturns) < numFrames);
+}
+
 // TODO: test scalar into FFT
 POTHOS_TEST_BLOCK("/numpy/tests", test_fft)
 {
@@ -562,3 +617,9 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_fft)
     testHFFT<float>();
     testHFFT<double>();
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_fft_batched)
+{
+    testBatchedFFT<std::complex<float>>();
+    testBatchedFFT<std::complex<double>>();
+}
@@ -0,0 +1,427 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Utility code
+//
+
+constexpr size_t bufferLen = 64;
+
+// Values within the domain of every function tested below.
+template <typename T>
+static NPTests::EnableIfAnyInt<T, Pothos::BufferChunk> getTestInputs(T)
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    return NPTests::getRandomInputs(dtype.name(), bufferLen);
+}
+
+template <typename T>
+static NPTests::EnableIfFloat<T, Pothos::BufferChunk> getTestInputs(T offset)
+{
+    return NPTests::stdVectorToBufferChunk(NPTests::linspace<T>(T(0.1)+offset, T(0.9)+offset, bufferLen));
+}
+
+template <typename T>
+static NPTests::EnableIfComplex<T, Pothos::BufferChunk> getTestInputs(T offset)
+{
+    using Scalar = typename T::value_type;
+
+    auto inputs = NPTests::toComplexVector(NPTests::linspace<Scalar>(Scalar(0.1), Scalar(0.9), bufferLen*2));
+    for(auto& input: inputs) input += offset;
+
+    return NPTests::stdVectorToBufferChunk(inputs);
+}
+
+//
+// Test code
+//
+
+// Make sure the block was instantiated in the expected environment, and that
+// its outputs match NumPy's.
+static void testBlockOutputs(
+    const std::string& funcName,
+    const std::string& expectedFuncName,
+    const std::string& expectedEnvironment,
+    const Pothos::DType& inputDType,
+    const Pothos::DType& outputDType,
+    const std::vector<Pothos::BufferChunk>& inputs,
+    Pothos::Proxy block)
+{
+    const std::string blockPath = "/numpy/" + funcName;
+
+    POTHOS_TEST_EQUAL(expectedEnvironment, block.getEnvironment()->getName());
+    POTHOS_TEST_EQUAL(blockPath, block.call<std::string>("getName"));
+
+    std::vector<Pothos::Proxy> feeders;
+    auto sink = Pothos::BlockRegistry::make("/blocks/collector_sink", outputDType);
+
+    {
+        Pothos::Topology topology;
+
+        for(size_t chan = 0; chan < inputs.size(); ++chan)
+        {
+            feeders.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", inputDType));
+            feeders.back().call("feedBuffer", inputs[chan]);
+
+            topology.connect(feeders.back(), 0, block, chan);
+        }
+        topology.connect(block, 0, sink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    NPTests::testBufferChunk(
+        testFuncs.call<Pothos::BufferChunk>(expectedFuncName, funcName, inputs, outputDType),
+        sink.call<Pothos::BufferChunk>("getBuffer"));
+}
+
+// Not from the Python fallback
+static void testNativeBlock(
+    const std::string& funcName,
+    const std::string& expectedFuncName,
+    const Pothos::DType& inputDType,
+    const Pothos::DType& outputDType,
+    const std::vector<Pothos::BufferChunk>& inputs,
+    Pothos::Proxy block)
+{
+    testBlockOutputs(funcName, expectedFuncName, "managed", inputDType, outputDType, inputs, block);
+}
+
+template <typename T>
+static void testNativeOneToOneBlock(
+    const std::string& funcName,
+    T inputOffset = T(0))
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    std::cout << " * Testing /numpy/" << funcName << "..." << std::endl;
+
+    testNativeBlock(
+        funcName,
+        "applyNumPyFunc",
+        dtype,
+        dtype,
+        {getTestInputs<T>(inputOffset)},
+        Pothos::BlockRegistry::make("/numpy/"+funcName, dtype));
+}
+
+template <typename T>
+static void testNativeComplexToScalarBlock(const std::string& funcName)
+{
+    static const Pothos::DType dtype(typeid(T));
+    static const Pothos::DType scalarDType(typeid(typename T::value_type));
+
+    std::cout << " * Testing /numpy/" << funcName << "..." << std::endl;
+
+    testNativeBlock(
+        funcName,
+        "applyNumPyFunc",
+        dtype,
+        scalarDType,
+        {getTestInputs<T>(T(0))},
+        Pothos::BlockRegistry::make("/numpy/"+funcName, dtype, scalarDType));
+}
+
+template <typename T>
+static void testNativeTwoToOneBlock(
+    const std::string& funcName,
+    T input0Offset = T(0),
+    T input1Offset = T(0))
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    std::cout << " * Testing /numpy/" << funcName << "..." << std::endl;
+
+    testNativeBlock(
+        funcName,
+        "applyNumPyFunc",
+        dtype,
+        dtype,
+        {getTestInputs<T>(input0Offset), getTestInputs<T>(input1Offset)},
+        Pothos::BlockRegistry::make("/numpy/"+funcName, dtype));
+}
+
+template <typename T>
+static void testNativeNToOneBlock(const std::string& funcName)
+{
+    static const Pothos::DType dtype(typeid(T));
+    static constexpr size_t nchans = 4;
+
+    std::cout << " * Testing /numpy/" << funcName << "..." << std::endl;
+
+    std::vector<Pothos::BufferChunk> inputs;
+    for(size_t chan = 0; chan < nchans; ++chan) inputs.emplace_back(getTestInputs<T>(T(chan)));
+
+    auto block = Pothos::BlockRegistry::make("/numpy/"+funcName, dtype, nchans);
+    POTHOS_TEST_EQUAL(nchans, block.call<size_t>("numChannels"));
+
+    testNativeBlock(
+        funcName,
+        "reduceNumPyFunc",
+        dtype,
+        dtype,
+        inputs,
+        block);
+}
+
+// NumPy integer math wraps around at the limits of the type.
+template <typename T>
+static void testNativeIntegerLimits(const std::string& funcName)
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    std::cout << " * Testing /numpy/" << funcName << " (limits)..." << std::endl;
+
+    const std::vector<T> inputs =
+    {
+        std::numeric_limits<T>::min(),
+        T(std::numeric_limits<T>::min() + 1),
+        T(0),
+        T(1),
+        T(std::numeric_limits<T>::max() - 1),
+        std::numeric_limits<T>::max()
+    };
+
+    testNativeBlock(
+        funcName,
+        "applyNumPyFunc",
+        dtype,
+        dtype,
+        {NPTests::stdVectorToBufferChunk(inputs)},
+        Pothos::BlockRegistry::make("/numpy/"+funcName, dtype));
+}
+
+template <typename T>
+static NPTests::EnableIfInteger<T, void> testNativeBlocks()
+{
+    std::cout << "Testing " << Pothos::DType(typeid(T)).toString() << "..." << std::endl;
+
+    for(const auto& funcName: {"square", "absolute", "invert", "positive", "negative"}) testNativeOneToOneBlock<T>(funcName);
+    for(const auto& funcName: {"square", "absolute", "negative"}) testNativeIntegerLimits<T>(funcName);
+
+    for(const auto& funcName: {"subtract", "remainder", "fmod", "bitwise_and", "bitwise_or", "bitwise_xor", "copysign"}) testNativeTwoToOneBlock<T>(funcName);
+    for(const auto& funcName: {"add", "multiply", "maximum", "minimum"}) testNativeNToOneBlock<T>(funcName);
+}
+
+template <typename T>
+static NPTests::EnableIfUnsignedInt<T, void> testNativeBlocks()
+{
+    std::cout << "Testing " << Pothos::DType(typeid(T)).toString() << "..." << std::endl;
+
+    testNativeOneToOneBlock<T>("square");
+    testNativeOneToOneBlock<T>("invert");
+    testNativeIntegerLimits<T>("square");
+
+    for(const auto& funcName: {"subtract", "remainder", "fmod", "bitwise_and", "bitwise_or", "bitwise_xor"}) testNativeTwoToOneBlock<T>(funcName);
+    for(const auto& funcName: {"add", "multiply", "maximum", "minimum"}) testNativeNToOneBlock<T>(funcName);
+}
+
+template <typename T>
+static NPTests::EnableIfFloat<T, void> testNativeBlocks()
+{
+    std::cout << "Testing " << Pothos::DType(typeid(T)).toString() << "..." << std::endl;
+
+    const std::vector<std::string> funcNames =
+    {
+        "reciprocal", "sqrt", "cbrt", "square", "absolute", "fabs",
+        "sin", "cos", "tan", "arcsin", "arccos", "arctan",
+        "sinh", "cosh", "tanh", "arcsinh", "arctanh",
+        "deg2rad", "rad2deg",
+        "exp", "expm1", "exp2", "log", "log10", "log2", "log1p",
+        "rint", "ceil", "floor", "trunc",
+        "positive", "negative", "sinc"
+    };
+    for(const auto& funcName: funcNames) testNativeOneToOneBlock<T>(funcName);
+
+    // Outside the domain of the others
+    testNativeOneToOneBlock<T>("arccosh", T(1));
+
+    // Use a negative numerator to make sure the sign conventions match.
+    const std::vector<std::string> twoToOneFuncNames =
+    {
+        "subtract", "divide", "true_divide", "floor_divide",
+        "remainder", "fmod", "logaddexp", "logaddexp2", "copysign"
+    };
+    for(const auto& funcName: twoToOneFuncNames) testNativeTwoToOneBlock<T>(funcName, T(-3), T(0.5));
+
+    for(const auto& funcName: {"add", "multiply", "maximum", "minimum"}) testNativeNToOneBlock<T>(funcName);
+}
+
+template <typename T>
+static NPTests::EnableIfComplex<T, void> testNativeBlocks()
+{
+    std::cout << "Testing " << Pothos::DType(typeid(T)).toString() << "..." << std::endl;
+
+    const std::vector<std::string> funcNames =
+    {
+        "reciprocal", "sqrt", "square",
+        "exp", "expm1", "exp2", "log", "log10", "log2", "log1p",
+        "rint", "conjugate", "positive", "negative"
+    };
+    for(const auto& funcName: funcNames) testNativeOneToOneBlock<T>(funcName);
+
+    for(const auto& funcName: {"angle", "real", "imag"}) testNativeComplexToScalarBlock<T>(funcName);
+
+    for(const auto& funcName: {"subtract", "divide", "true_divide"}) testNativeTwoToOneBlock<T>(funcName, T(-3), T(0.5));
+    for(const auto& funcName: {"add", "multiply"}) testNativeNToOneBlock<T>(funcName);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_native_blocks)
+{
+    testNativeBlocks<std::int8_t>();
+    testNativeBlocks<std::int16_t>();
+    testNativeBlocks<std::int32_t>();
+    testNativeBlocks<std::int64_t>();
+    testNativeBlocks<std::uint8_t>();
+    testNativeBlocks<std::uint16_t>();
+    testNativeBlocks<std::uint32_t>();
+    testNativeBlocks<std::uint64_t>();
+    testNativeBlocks<float>();
+    testNativeBlocks<double>();
+    testNativeBlocks<std::complex<float>>();
+    testNativeBlocks<std::complex<double>>();
+}
+
+//
+// Every ufunc block with a native implementation is instantiated natively, so
+// the Python blocks' supportsOut path is only taken for other DTypes. Build
+// the Python blocks directly, with an output type that must be cast to.
+//
+
+static void testPythonUfuncBlock(
+    const std::string& funcName,
+    const std::string& expectedFuncName,
+    const Pothos::DType& inputDType,
+    const Pothos::DType& outputDType,
+    const std::vector<Pothos::BufferChunk>& inputs)
+{
+    std::cout << " * Testing /numpy/" << funcName << " (" << inputDType.name() << " -> " << outputDType.name() << ")..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    testBlockOutputs(
+        funcName,
+        expectedFuncName,
+        "python",
+        inputDType,
+        outputDType,
+        inputs,
+        testFuncs.call("makePythonUfuncBlock", funcName, inputDType, outputDType, inputs.size()));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_python_ufunc_out)
+{
+    testPythonUfuncBlock(
+        "sqrt",
+        "applyNumPyFunc",
+        "float64",
+        "float32",
+        {getTestInputs<double>(0.0)});
+    testPythonUfuncBlock(
+        "subtract",
+        "applyNumPyFunc",
+        "float64",
+        "float32",
+        {getTestInputs<double>(-3.0), getTestInputs<double>(0.5)});
+
+    // Integer inputs, so accumulating into the output gives exactly the same
+    // result as reducing first.
+    std::vector<Pothos::BufferChunk> inputs;
+    for(std::int32_t chan = 0; chan < 4; ++chan) inputs.emplace_back(getTestInputs<std::int32_t>(chan));
+
+    testPythonUfuncBlock(
+        "add",
+        "reduceNumPyFunc",
+        "int32",
+        "int64",
+        inputs);
+}
+
+//
+// Native blocks never call into Python, so independent chains of them
+// shouldn't serialize on the interpreter lock.
+//
+
+static double getChainsRuntimeSecs(
+    const std::string& blockPath,
+    const Pothos::BufferChunk& inputs,
+    size_t numChains)
+{
+    std::vector<Pothos::Proxy> feeders, blocks, sinks;
+    Pothos::Topology topology;
+
+    for(size_t chain = 0; chain < numChains; ++chain)
+    {
+        feeders.emplace_back(Pothos::BlockRegistry::make("/blocks/feeder_source", inputs.dtype));
+        feeders.back().call("feedBuffer", inputs);
+
+        blocks.emplace_back(Pothos::BlockRegistry::make(blockPath, inputs.dtype));
+        POTHOS_TEST_EQUAL("managed", blocks.back().getEnvironment()->getName());
+
+        sinks.emplace_back(Pothos::BlockRegistry::make("/blocks/collector_sink", inputs.dtype));
+
+        topology.connect(feeders.back(), 0, blocks.back(), 0);
+        topology.connect(blocks.back(), 0, sinks.back(), 0);
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitInactive(0.01, 60.0));
+    const auto endTime = std::chrono::steady_clock::now();
+
+    for(const auto& sink: sinks)
+    {
+        POTHOS_TEST_EQUAL(
+            inputs.elements(),
+            sink.call<Pothos::BufferChunk>("getBuffer").elements());
+    }
+
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_native_block_scaling)
+{
+    constexpr size_t numElements = 1 << 22;
+    const std::string blockPath = "/numpy/arcsinh";
+
+    const size_t numChains = std::min<size_t>(4, std::thread::hardware_concurrency());
+    if(numChains < 2)
+    {
+        std::cout << "Not enough cores to test scaling, skipping." << std::endl;
+        return;
+    }
+
+    const auto inputs = NPTests::stdVectorToBufferChunk(NPTests::linspace<double>(-10.0, 10.0, numElements));
+
+    const auto oneChainSecs = getChainsRuntimeSecs(blockPath, inputs, 1);
+    const auto allChainsSecs = getChainsRuntimeSecs(blockPath, inputs, numChains);
+
+    // If the chains were serialized, this would be around 1. Wall-clock
+    // timing depends too much on the machine's load to assert on, so this
+    // is only reported. Running PothosNumPyBenchmark with a chain count
+    // reports the same comparison for every block, type, and buffer size.
+    const auto speedup = (oneChainSecs * numChains) / allChainsSecs;
+    std::cout << numChains << " chains: " << speedup << "x throughput of 1 chain" << std::endl;
+}
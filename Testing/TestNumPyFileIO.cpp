@@ -22,6 +22,7 @@
 #include <random>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 constexpr size_t kNumChannels = 4;
@@ -51,6 +52,21 @@ static std::string getTemporaryTestFile(
 }
 
 
+// This works for both native and Python blocks. The Python blocks' dtype()
+// functions return NumPy dtypes.
+static Pothos::DType getPortDType(
+    const Pothos::Proxy& block,
+    const std::string& portInfoCall,
+    const size_t port)
+{
+    for(const auto& portInfo: block.call<std::vector<Pothos::PortInfo>>(portInfoCall))
+    {
+        if(portInfo.name == std::to_string(port)) return portInfo.dtype;
+    }
+
+    throw Pothos::NotFoundException("Could not find port", std::to_string(port));
+}
+
 template <typename T>
 static inline NPTests::EnableIfNotComplex<T, T> getEpsilon()
 {
@@ -139,9 +155,7 @@ static void test1DSource(
     const Pothos::Proxy& testBlock,
     const Pothos::BufferChunk& expectedOutputs)
 {
-    // Note: we need to get the Python class's internal port because the Python
-    // class's dtype() function returns the NumPy dtype.
-    const auto dtype = testBlock.call("output", 0).get("_port").call<Pothos::DType>("dtype");
+    const auto dtype = getPortDType(testBlock, "outputPortInfo", 0);
 
     auto collectorSink = Pothos::BlockRegistry::make(
                              "/blocks/collector_sink",
@@ -171,9 +185,7 @@ static void test2DSource(
     const Pothos::Proxy& testBlock,
     const std::vector<Pothos::BufferChunk>& expectedOutputs)
 {
-    // Note: we need to get the Python class's internal port because the Python
-    // class's dtype() function returns the NumPy dtype.
-    const auto dtype = testBlock.call("output", 0).get("_port").call<Pothos::DType>("dtype");
+    const auto dtype = getPortDType(testBlock, "outputPortInfo", 0);
 
     std::vector<Pothos::Proxy> collectorSinks;
     for(size_t port = 0; port < kNumChannels; ++port)
@@ -212,10 +224,13 @@ static void test2DSource(
 // Test implementation
 //
 
-static void testNpySource1D(const std::string& type)
+static void testNpySource1D(
+    const std::string& type,
+    const std::string& generatorName,
+    const std::string& description)
 {
     const Pothos::DType dtype(type);
-    std::cout << "Testing " << dtype.toString() << " (1D)..." << std::endl;
+    std::cout << "Testing " << dtype.toString() << " (" << description << ")..." << std::endl;
 
     const std::string filepath = getTemporaryTestFile(dtype, ".npy");
 
@@ -227,7 +242,7 @@ static void testNpySource1D(const std::string& type)
     auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
     auto expectedOutputs = testFuncs.call(
-                               "generate1DNpyFile",
+                               generatorName,
                                filepath,
                                dtype);
     POTHOS_TEST_TRUE(
@@ -248,24 +263,22 @@ static void testNpySource1D(const std::string& type)
         numpyNpySource.call<std::string>("filepath"));
     POTHOS_TEST_FALSE(numpyNpySource.call<bool>("repeat"));
 
-    // Note: we need to get the Python class's internal port because the Python
-    // class's dtype() function returns the NumPy dtype.
     POTHOS_TEST_EQUAL(
         dtype.name(),
-        numpyNpySource.call("output", 0)
-                      .get("_port")
-                      .call("dtype")
-                      .call<std::string>("name"));
+        getPortDType(numpyNpySource, "outputPortInfo", 0).name());
 
     test1DSource(
         numpyNpySource,
         expectedOutputs);
 }
 
-static void testNpySource2D(const std::string& type)
+static void testNpySource2D(
+    const std::string& type,
+    const std::string& generatorName,
+    const std::string& description)
 {
     const Pothos::DType dtype(type);
-    std::cout << "Testing " << dtype.toString() << " (2D)..." << std::endl;
+    std::cout << "Testing " << dtype.toString() << " (" << description << ")..." << std::endl;
 
     const std::string filepath = getTemporaryTestFile(dtype, ".npy");
 
@@ -277,7 +290,7 @@ static void testNpySource2D(const std::string& type)
     auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
     auto expectedOutputs = convert2DNumPyArrayToBufferChunks(testFuncs.call(
-                               "generate2DNpyFile",
+                               generatorName,
                                filepath,
                                dtype));
     POTHOS_TEST_TRUE(Poco::File(filepath).exists());
@@ -291,16 +304,11 @@ static void testNpySource2D(const std::string& type)
         numpyNpySource.call<std::string>("filepath"));
     POTHOS_TEST_FALSE(numpyNpySource.call<bool>("repeat"));
 
-    // Note: we need to get the Python class's internal port because the Python
-    // class's dtype() function returns the NumPy dtype.
     for(size_t chan = 0; chan < kNumChannels; ++chan)
     {
         POTHOS_TEST_EQUAL(
             dtype.name(),
-            numpyNpySource.call("output", chan)
-                          .get("_port")
-                          .call("dtype")
-                          .call<std::string>("name"));
+            getPortDType(numpyNpySource, "outputPortInfo", chan).name());
     }
 
     test2DSource(
@@ -310,8 +318,219 @@ static void testNpySource2D(const std::string& type)
 
 static void testNpySource(const std::string& type)
 {
-    testNpySource1D(type);
-    testNpySource2D(type);
+    testNpySource1D(type, "generate1DNpyFile", "1D");
+    testNpySource2D(type, "generate2DNpyFile", "2D");
+
+    // These can't be used in place, so they're copied into the output buffers.
+    testNpySource1D(type, "generateBigEndian1DNpyFile", "1D, big-endian");
+    testNpySource2D(type, "generateFortranOrder2DNpyFile", "2D, Fortran order");
+}
+
+// Every file should be played back to back, whether listed or matched by
+// a pattern.
+static void testNpyPlaylistSource(const std::string& type)
+{
+    static constexpr size_t numFiles = 3;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (playlist)" << std::endl;
+
+    const std::string prefix = getTemporaryTestFile(dtype, "_playlist");
+
+    std::vector<std::string> filepaths;
+    for(size_t index = 0; index < numFiles; ++index)
+    {
+        filepaths.emplace_back(prefix + std::to_string(index) + ".npy");
+        Poco::TemporaryFile::registerForDeletion(filepaths.back());
+    }
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = convert2DNumPyArrayToBufferChunks(testFuncs.call(
+                               "generate2DNpyPlaylist",
+                               filepaths,
+                               dtype));
+
+    for(const auto& playlist: {filepaths, std::vector<std::string>{prefix + "*.npy"}})
+    {
+        auto playlistSource = Pothos::BlockRegistry::make(
+                                  "/numpy/npy_playlist_source",
+                                  playlist,
+                                  false /*repeat*/);
+        POTHOS_TEST_TRUE(filepaths == playlistSource.call<std::vector<std::string>>("filepaths"));
+        POTHOS_TEST_FALSE(playlistSource.call<bool>("repeat"));
+
+        for(size_t chan = 0; chan < kNumChannels; ++chan)
+        {
+            POTHOS_TEST_EQUAL(
+                dtype.name(),
+                getPortDType(playlistSource, "outputPortInfo", chan).name());
+        }
+
+        test2DSource(
+            playlistSource,
+            expectedOutputs);
+    }
+
+    // Every file must match the first.
+    const std::string mismatchedFilepath = prefix + "_mismatched.npy";
+    Poco::TemporaryFile::registerForDeletion(mismatchedFilepath);
+    testFuncs.call("generate1DNpyFile", mismatchedFilepath, dtype);
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/npy_playlist_source",
+            std::vector<std::string>{filepaths[0], mismatchedFilepath},
+            false),
+        Pothos::Exception);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/npy_playlist_source",
+            std::vector<std::string>{prefix + "_nonexistent*.npy"},
+            false),
+        Pothos::Exception);
+}
+
+// Only the window should be output, starting wherever it was seeked to.
+static void testFileSourceWindow(
+    const std::string& blockPath,
+    const size_t seekOffset)
+{
+    static constexpr size_t startIndex = 64;
+    static constexpr size_t count = 100;
+
+    std::cout << "Testing " << blockPath << " window (seek offset: " << seekOffset << ")..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    const bool isNpz = ("/numpy/npz_source" == blockPath);
+    const std::string key = "int32_1D";
+    const std::string filepath = getTemporaryTestFile(isNpz ? ".npz" : ".npy");
+
+    Pothos::BufferChunk allValues;
+    if(isNpz)
+    {
+        Npz1DContentsMap testValues1D;
+        Npz2DContentsMap testValues2D;
+        proxyMapToNpzTestInputs(
+            testFuncs.call("generateNpzFile", filepath, false /*compressed*/),
+            &testValues1D,
+            &testValues2D);
+
+        allValues = testValues1D.at(key);
+    }
+    else allValues = testFuncs.call<Pothos::BufferChunk>("generate1DNpyFile", filepath, Pothos::DType("int32"));
+
+    auto source = isNpz ? Pothos::BlockRegistry::make(
+                              blockPath,
+                              filepath,
+                              key,
+                              false /*repeat*/)
+                        : Pothos::BlockRegistry::make(
+                              blockPath,
+                              filepath,
+                              false /*repeat*/);
+
+    source.call("setStartIndex", startIndex);
+    source.call("setCount", count);
+    POTHOS_TEST_EQUAL(allValues.elements(), source.call<size_t>("numElements"));
+    POTHOS_TEST_EQUAL(startIndex, source.call<size_t>("startIndex"));
+    POTHOS_TEST_EQUAL(count, source.call<size_t>("count"));
+    POTHOS_TEST_EQUAL(startIndex, source.call<size_t>("position"));
+
+    POTHOS_TEST_THROWS(source.call("setStartIndex", allValues.elements()+1), Pothos::Exception);
+    POTHOS_TEST_THROWS(source.call("seek", startIndex-1), Pothos::Exception);
+    POTHOS_TEST_THROWS(source.call("seek", startIndex+count+1), Pothos::Exception);
+
+    source.call("seek", startIndex+seekOffset);
+    POTHOS_TEST_EQUAL(startIndex+seekOffset, source.call<size_t>("position"));
+
+    auto expectedOutputs = allValues;
+    expectedOutputs.address += (startIndex+seekOffset) * expectedOutputs.dtype.elemSize();
+    expectedOutputs.length = (count-seekOffset) * expectedOutputs.dtype.elemSize();
+
+    test1DSource(
+        source,
+        expectedOutputs);
+}
+
+// Read-ahead only changes when pages are read, so the output should be the
+// same with every combination of settings.
+static void testNpySourceReadAhead(
+    const bool dropReadPages,
+    const bool prefetchThread)
+{
+    const Pothos::DType dtype("complex_float64");
+    std::cout << "Testing /numpy/npy_source read-ahead (drop: " << dropReadPages
+              << ", prefetch: " << prefetchThread << ")..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    const auto makeSource = [&](const std::string& filepath)
+    {
+        auto source = Pothos::BlockRegistry::make(
+                          "/numpy/npy_source",
+                          filepath,
+                          false /*repeat*/);
+        source.call("setReadAheadMB", 0.001);
+        source.call("setDropReadPages", dropReadPages);
+        source.call("setPrefetchThread", prefetchThread);
+        POTHOS_TEST_EQUAL(0.001, source.call<double>("readAheadMB"));
+        POTHOS_TEST_EQUAL(dropReadPages, source.call<bool>("dropReadPages"));
+        POTHOS_TEST_EQUAL(prefetchThread, source.call<bool>("prefetchThread"));
+        POTHOS_TEST_THROWS(source.call("setReadAheadMB", -1.0), Pothos::Exception);
+
+        return source;
+    };
+
+    const std::string filepath1D = getTemporaryTestFile(dtype, ".npy");
+    auto expectedOutputs1D = testFuncs.call<Pothos::BufferChunk>(
+                                 "generate1DNpyFile",
+                                 filepath1D,
+                                 dtype);
+    test1DSource(makeSource(filepath1D), expectedOutputs1D);
+
+    const std::string filepath2D = getTemporaryTestFile(dtype, ".npy");
+    auto expectedOutputs2D = convert2DNumPyArrayToBufferChunks(testFuncs.call(
+                                 "generate2DNpyFile",
+                                 filepath2D,
+                                 dtype));
+    test2DSource(makeSource(filepath2D), expectedOutputs2D);
+
+    // Pages are only dropped once playback is a few windows into the file.
+    if(dropReadPages)
+    {
+        const std::string longFilepath = getTemporaryTestFile(dtype, "_long.npy");
+        auto expectedLongOutputs = testFuncs.call<Pothos::BufferChunk>(
+                                       "generateLong1DNpyFile",
+                                       longFilepath,
+                                       dtype,
+                                       size_t(1 << 16));
+
+        auto longSource = makeSource(longFilepath);
+        auto collectorSink = Pothos::BlockRegistry::make(
+                                 "/blocks/collector_sink",
+                                 dtype);
+        {
+            Pothos::Topology topology;
+            topology.connect(
+                longSource, 0,
+                collectorSink, 0);
+
+            topology.commit();
+            POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+        }
+
+        NPTests::testBufferChunk(
+            collectorSink.call("getBuffer"),
+            expectedLongOutputs);
+#ifndef _WIN32
+        POTHOS_TEST_GT(longSource.call<double>("droppedReadMB"), 0.0);
+#endif
+    }
 }
 
 static void testNpySink(const std::string& type)
@@ -369,184 +588,587 @@ static void testNpySink(const std::string& type)
     testFuncs.call("checkNpyContents", filepath, randomInputs);
 }
 
-static void testNpzSource1D(
-    const std::string& filepath,
-    const std::string& key,
-    const Pothos::BufferChunk& expectedOutputs)
+// Write each input to its own channel, then check the channels with NumPy
+// and by reading the file back in.
+static void testMultichannelFileSink(
+    const std::string& blockPath,
+    const std::string& type)
 {
-    auto numpyNpzSource = Pothos::BlockRegistry::make(
-                              "/numpy/npz_source",
-                              filepath,
-                              key,
-                              false /*repeat*/);
+    static constexpr size_t numElements = 256;
 
-    // Note: we need to get the Python object's internal port proxy because
-    // the Python class returns a NumPy DType.
-    auto dtype = numpyNpzSource.call("output", "0")
-                               .get("_port")
-                               .call<Pothos::DType>("dtype");
-    POTHOS_TEST_EQUAL(expectedOutputs.dtype.name(), dtype.name());
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << blockPath << " with " << dtype.toString() << " (" << kNumChannels << " channels)" << std::endl;
 
-    std::cout << " * Testing " << dtype.name() << " (1D)..." << std::endl;
+    const bool isNpz = ("/numpy/npz_sink" == blockPath);
+    const std::string filepath = getTemporaryTestFile(dtype, isNpz ? ".npz" : ".npy");
+    const std::string key = "multichannel";
 
-    test1DSource(
-        numpyNpzSource,
-        expectedOutputs);
-}
+    auto sink = isNpz ? Pothos::BlockRegistry::make(
+                            blockPath,
+                            filepath,
+                            key,
+                            dtype,
+                            kNumChannels,
+                            false /*compressed*/,
+                            false /*append*/)
+                      : Pothos::BlockRegistry::make(
+                            blockPath,
+                            filepath,
+                            dtype,
+                            kNumChannels,
+                            false /*append*/);
 
-static void testNpzSource2D(
-    const std::string& filepath,
-    const std::string& key,
-    const std::vector<Pothos::BufferChunk>& expectedOutputs)
-{
-    auto numpyNpzSource = Pothos::BlockRegistry::make(
+    std::vector<Pothos::BufferChunk> randomInputs;
+    std::vector<Pothos::Proxy> feederSources;
+    for(size_t chan = 0; chan < kNumChannels; ++chan)
+    {
+        randomInputs.emplace_back(NPTests::getRandomInputs(type, numElements));
+
+        feederSources.emplace_back(Pothos::BlockRegistry::make(
+                                       "/blocks/feeder_source",
+                                       dtype));
+        feederSources.back().call("feedBuffer", randomInputs.back());
+    }
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < kNumChannels; ++chan)
+        {
+            topology.connect(
+                feederSources[chan], 0,
+                sink, chan);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    for(size_t chan = 0; chan < kNumChannels; ++chan)
+    {
+        if(isNpz) testFuncs.call("checkNpzChannelContents", filepath, key, chan, randomInputs[chan]);
+        else      testFuncs.call("checkNpyChannelContents", filepath, chan, randomInputs[chan]);
+    }
+
+    auto source = isNpz ? Pothos::BlockRegistry::make(
                               "/numpy/npz_source",
                               filepath,
                               key,
+                              false /*repeat*/)
+                        : Pothos::BlockRegistry::make(
+                              "/numpy/npy_source",
+                              filepath,
                               false /*repeat*/);
-
-    // Note: we need to get the Python object's internal port proxy because
-    // the Python class returns a NumPy DType.
-    auto dtype = numpyNpzSource.call("output", "0")
-                               .get("_port")
-                               .call<Pothos::DType>("dtype");
-
-    std::cout << " * Testing " << dtype.name() << " (2D)..." << std::endl;
-
-    test2DSource(
-        numpyNpzSource,
-        expectedOutputs);
+    test2DSource(source, randomInputs);
 }
 
-static void testNpzSource(bool compressed)
+// Appending to a file written by NumPy should update its header in place.
+// Samples left past the header's shape by an interrupted capture should be
+// kept.
+static void testNpySinkAppend(
+    const std::string& type,
+    const std::string& generatorName)
 {
-    if(compressed)
-    {
-        std::cout << "Testing loading compressed .npz file." << std::endl;
-    }
-    else
-    {
-        std::cout << "Testing loading uncompressed .npz file." << std::endl;
-    }
+    static constexpr size_t numElements = 256;
 
-    const std::string filepath = getTemporaryTestFile(".npz");
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (append to " << generatorName << ")" << std::endl;
 
-    //
-    // Generate our test file in NumPy and save our expected values.
-    //
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+    const auto randomInputs = NPTests::getRandomInputs(type, numElements);
 
     auto env = Pothos::ProxyEnvironment::make("python");
     auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
-    auto expectedOutputs = testFuncs.call(
-                               "generateNpzFile",
-                               filepath,
-                               compressed);
-    POTHOS_TEST_TRUE(
-        typeid(Pothos::ProxyMap) ==
-        expectedOutputs.toObject().type());
+    auto originalValues = testFuncs.call(
+                              generatorName,
+                              filepath,
+                              dtype);
     POTHOS_TEST_TRUE(Poco::File(filepath).exists());
 
-    Npz1DContentsMap testValues1D;
-    Npz2DContentsMap testValues2D;
-    proxyMapToNpzTestInputs(
-        expectedOutputs,
-        &testValues1D,
-        &testValues2D);
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", randomInputs);
 
-    for(const auto& testValues: testValues1D)
-    {
-        const auto& key = testValues.first;
-        const auto& expectedOutputs = testValues.second;
-        testNpzSource1D(filepath, key, expectedOutputs);
-    }
-    for(const auto& testValues: testValues2D)
+    auto numpySave = Pothos::BlockRegistry::make(
+                         "/numpy/npy_sink",
+                         filepath,
+                         dtype,
+                         1 /*nchans*/,
+                         true /*append*/);
+    POTHOS_TEST_TRUE(numpySave.call<bool>("append"));
+
+    // Execute the topology.
     {
-        const auto& key = testValues.first;
-        const auto& expectedOutputs = testValues.second;
-        testNpzSource2D(filepath, key, expectedOutputs);
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            numpySave, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
     }
+
+    testFuncs.call(
+        "checkAppendedNpyContents",
+        filepath,
+        originalValues,
+        randomInputs);
 }
 
-static void testNpzSink(
-    const std::string& filepath,
-    const std::string& key,
-    bool compressed,
-    bool append,
-    const Pothos::BufferChunk& values)
+// The file shouldn't be replaced if nothing is written to it.
+static void testNpySinkNoSamples()
 {
-    const auto& dtype = values.dtype;
+    const Pothos::DType dtype("int32");
+    std::cout << "Testing " << dtype.toString() << " (no samples)" << std::endl;
 
-    auto numpyNpzSink = Pothos::BlockRegistry::make(
-                            "/numpy/npz_sink",
-                            filepath,
-                            key,
-                            dtype,
-                            1 /*nchans*/,
-                            compressed,
-                            append);
-    POTHOS_TEST_EQUAL(
-        filepath,
-        numpyNpzSink.call<std::string>("filepath"));
-    POTHOS_TEST_EQUAL(
-        key,
-        numpyNpzSink.call<std::string>("key"));
-    POTHOS_TEST_EQUAL(
-        compressed,
-        numpyNpzSink.call<bool>("compressed"));
-    POTHOS_TEST_EQUAL(
-        append,
-        numpyNpzSink.call<bool>("append"));
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
 
-    if(append)
-    {
-        const auto allKeys = numpyNpzSink.call<std::vector<std::string>>("allKeys");
-        POTHOS_TEST_TRUE(allKeys.end() != std::find(allKeys.begin(), allKeys.end(), key));
-    }
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
-    // Note: we need to get the Python class's internal port because the Python
-    // class's dtype() function returns the NumPy dtype.
-    POTHOS_TEST_EQUAL(
-        dtype.name(),
-        numpyNpzSink.call("input", 0)
-                    .get("_port")
-                    .call("dtype")
-                    .call<std::string>("name"));
+    auto originalValues = testFuncs.call(
+                              "generate1DNpyFile",
+                              filepath,
+                              dtype);
 
     auto feederSource = Pothos::BlockRegistry::make(
                             "/blocks/feeder_source",
                             dtype);
-    feederSource.call("feedBuffer", values);
+    auto numpySave = Pothos::BlockRegistry::make(
+                         "/numpy/npy_sink",
+                         filepath,
+                         dtype,
+                         1 /*nchans*/,
+                         false /*append*/);
 
     // Execute the topology.
     {
         Pothos::Topology topology;
-
         topology.connect(
             feederSource, 0,
-            numpyNpzSink, 0);
+            numpySave, 0);
 
         topology.commit();
-
-        // When this block exits, the flowgraph will stop.
-        Poco::Thread::sleep(10);
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
     }
+
+    testFuncs.call(
+        "checkNpyContents",
+        filepath,
+        originalValues);
 }
 
-static void testNpzSink(bool compressed)
+// Each segment should be a complete file by the time the topology stops,
+// starting at each sample count or label boundary.
+static void testNpySinkSegments(const std::string& segmentBy)
 {
     static constexpr size_t numElements = 256;
+    static const std::string type = "int32";
 
-    static constexpr size_t minSize = (numElements * sizeof(std::int8_t))
-                                    + (numElements * sizeof(std::int16_t))
-                                    + (numElements * sizeof(std::int32_t))
-                                    + (numElements * sizeof(std::uint8_t))
-                                    + (numElements * sizeof(std::uint16_t))
-                                    + (numElements * sizeof(std::uint32_t))
-                                    + (numElements * sizeof(float))
-                                    + (numElements * sizeof(double))
-                                    + (numElements * sizeof(std::complex<float>))
-                                    + (numElements * sizeof(std::complex<double>));
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (segmented by " << segmentBy << ")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+    const auto randomInputs = NPTests::getRandomInputs(type, numElements);
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", randomInputs);
+
+    auto numpySave = Pothos::BlockRegistry::make(
+                         "/numpy/npy_sink",
+                         filepath,
+                         dtype,
+                         1 /*nchans*/,
+                         false /*append*/);
+    numpySave.call("setSegmentNaming", "numbered");
+    POTHOS_TEST_THROWS(numpySave.call("setSegmentNaming", "random"), Pothos::Exception);
+    POTHOS_TEST_THROWS(numpySave.call("setSegmentSeconds", -1.0), Pothos::Exception);
+
+    // The index each segment starts at
+    std::vector<size_t> segmentStarts;
+    if("samples" == segmentBy)
+    {
+        numpySave.call("setSegmentSamples", 100);
+        POTHOS_TEST_EQUAL(size_t(100), numpySave.call<size_t>("segmentSamples"));
+
+        segmentStarts = {0, 100, 200};
+    }
+    else
+    {
+        numpySave.call("setSegmentLabel", "segment");
+        POTHOS_TEST_EQUAL("segment", numpySave.call<std::string>("segmentLabel"));
+
+        feederSource.call("feedLabels", std::vector<Pothos::Label>
+        {
+            Pothos::Label("segment", 0, 50),
+            Pothos::Label("segment", 0, 200)
+        });
+
+        segmentStarts = {0, 50, 200};
+    }
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            numpySave, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    POTHOS_TEST_EQUAL(
+        segmentStarts.size(),
+        numpySave.call<size_t>("numSegments"));
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    for(size_t segment = 0; segment < segmentStarts.size(); ++segment)
+    {
+        Poco::Path segmentPath(filepath);
+        segmentPath.setBaseName(segmentPath.getBaseName() + "_00000" + std::to_string(segment));
+        Poco::TemporaryFile::registerForDeletion(segmentPath.toString());
+
+        POTHOS_TEST_TRUE(Poco::File(segmentPath).exists());
+        POTHOS_TEST_FALSE(Poco::File(segmentPath.toString() + ".part").exists());
+
+        const auto segmentEnd = ((segment + 1) < segmentStarts.size()) ? segmentStarts[segment+1] : numElements;
+
+        auto expectedValues = randomInputs;
+        expectedValues.address += segmentStarts[segment] * dtype.elemSize();
+        expectedValues.length = (segmentEnd - segmentStarts[segment]) * dtype.elemSize();
+
+        testFuncs.call("checkNpyContents", segmentPath.toString(), expectedValues);
+
+        if((segment + 1) == segmentStarts.size())
+        {
+            POTHOS_TEST_EQUAL(
+                segmentPath.toString(),
+                numpySave.call<std::string>("lastSegmentPath"));
+        }
+    }
+}
+
+// Each capture should be the samples leading up to its trigger, followed by
+// the samples from it onward. Triggers during a capture are ignored.
+static void testNpyTriggerSink(const std::string& triggerBy)
+{
+    static constexpr size_t numElements = 256;
+    static constexpr size_t preTrigger = 16;
+    static constexpr size_t postTrigger = 32;
+
+    const bool byLabel = ("label" == triggerBy);
+    const size_t nchans = byLabel ? 2 : 1;
+    const Pothos::DType dtype(byLabel ? "int32" : "float32");
+    std::cout << "Testing " << dtype.toString() << " (triggered by " << triggerBy << ")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+
+    std::vector<Pothos::BufferChunk> inputs;
+    std::vector<Pothos::Proxy> feederSources;
+
+    auto numpyTriggerSave = Pothos::BlockRegistry::make(
+                                "/numpy/npy_trigger_sink",
+                                filepath,
+                                dtype,
+                                nchans,
+                                preTrigger,
+                                postTrigger);
+    POTHOS_TEST_EQUAL(preTrigger, numpyTriggerSave.call<size_t>("preTrigger"));
+    POTHOS_TEST_EQUAL(postTrigger, numpyTriggerSave.call<size_t>("postTrigger"));
+    POTHOS_TEST_THROWS(numpyTriggerSave.call("setPostTrigger", size_t(0)), Pothos::Exception);
+    POTHOS_TEST_THROWS(numpyTriggerSave.call("setTriggerLevel", -1.0), Pothos::Exception);
+    POTHOS_TEST_THROWS(numpyTriggerSave.call("setCaptureNaming", "random"), Pothos::Exception);
+
+    // The range of samples in each capture
+    std::vector<std::pair<size_t, size_t>> captures;
+    if(byLabel)
+    {
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            inputs.emplace_back(NPTests::getRandomInputs(dtype.name(), numElements));
+        }
+
+        // The first capture starts too early for a full pre-trigger window,
+        // and the last is cut short by the end of the stream.
+        numpyTriggerSave.call("setTriggerLabel", "MAX");
+        POTHOS_TEST_EQUAL("MAX", numpyTriggerSave.call<std::string>("triggerLabel"));
+
+        captures = {{0, 37}, {84, 132}, {234, 256}};
+    }
+    else
+    {
+        // The spikes at 60 and 71 are during the first capture, and 72
+        // doesn't cross the level because 71 was already above it.
+        Pothos::BufferChunk input(dtype, numElements);
+        auto* samples = input.as<float*>();
+        std::fill(samples, samples + numElements, 0.0f);
+        for(const size_t index: {40, 41, 60, 71, 72}) samples[index] = 1.0f;
+        samples[150] = -1.0f;
+
+        inputs.emplace_back(input);
+
+        numpyTriggerSave.call("setTriggerLevel", 0.5);
+        POTHOS_TEST_EQUAL(0.5, numpyTriggerSave.call<double>("triggerLevel"));
+
+        captures = {{24, 72}, {134, 182}};
+    }
+
+    for(size_t chan = 0; chan < nchans; ++chan)
+    {
+        feederSources.emplace_back(Pothos::BlockRegistry::make(
+                                       "/blocks/feeder_source",
+                                       dtype));
+        feederSources.back().call("feedBuffer", inputs[chan]);
+    }
+
+    // Labels on any input trigger every channel.
+    if(byLabel)
+    {
+        feederSources.back().call("feedLabels", std::vector<Pothos::Label>
+        {
+            Pothos::Label("MAX", 0, 5),
+            Pothos::Label("MAX", 0, 20),
+            Pothos::Label("MAX", 0, 100),
+            Pothos::Label("MAX", 0, 250)
+        });
+    }
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            topology.connect(
+                feederSources[chan], 0,
+                numpyTriggerSave, chan);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    POTHOS_TEST_EQUAL(
+        captures.size(),
+        numpyTriggerSave.call<size_t>("numCaptures"));
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    for(size_t capture = 0; capture < captures.size(); ++capture)
+    {
+        Poco::Path capturePath(filepath);
+        capturePath.setBaseName(capturePath.getBaseName() + "_00000" + std::to_string(capture));
+        Poco::TemporaryFile::registerForDeletion(capturePath.toString());
+
+        POTHOS_TEST_TRUE(Poco::File(capturePath).exists());
+        POTHOS_TEST_FALSE(Poco::File(capturePath.toString() + ".part").exists());
+
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            auto expectedValues = inputs[chan];
+            expectedValues.address += captures[capture].first * dtype.elemSize();
+            expectedValues.length = (captures[capture].second - captures[capture].first) * dtype.elemSize();
+
+            if(1 == nchans) testFuncs.call("checkNpyContents", capturePath.toString(), expectedValues);
+            else            testFuncs.call("checkNpyChannelContents", capturePath.toString(), chan, expectedValues);
+        }
+
+        if((capture + 1) == captures.size())
+        {
+            POTHOS_TEST_EQUAL(
+                capturePath.toString(),
+                numpyTriggerSave.call<std::string>("lastCapturePath"));
+        }
+    }
+}
+
+static void testNpzSource1D(
+    const std::string& filepath,
+    const std::string& key,
+    const Pothos::BufferChunk& expectedOutputs)
+{
+    auto numpyNpzSource = Pothos::BlockRegistry::make(
+                              "/numpy/npz_source",
+                              filepath,
+                              key,
+                              false /*repeat*/);
+
+    auto dtype = getPortDType(numpyNpzSource, "outputPortInfo", 0);
+    POTHOS_TEST_EQUAL(expectedOutputs.dtype.name(), dtype.name());
+
+    std::cout << " * Testing " << dtype.name() << " (1D)..." << std::endl;
+
+    test1DSource(
+        numpyNpzSource,
+        expectedOutputs);
+}
+
+static void testNpzSource2D(
+    const std::string& filepath,
+    const std::string& key,
+    const std::vector<Pothos::BufferChunk>& expectedOutputs)
+{
+    auto numpyNpzSource = Pothos::BlockRegistry::make(
+                              "/numpy/npz_source",
+                              filepath,
+                              key,
+                              false /*repeat*/);
+
+    auto dtype = getPortDType(numpyNpzSource, "outputPortInfo", 0);
+
+    std::cout << " * Testing " << dtype.name() << " (2D)..." << std::endl;
+
+    test2DSource(
+        numpyNpzSource,
+        expectedOutputs);
+}
+
+static void testNpzSource(bool compressed)
+{
+    if(compressed)
+    {
+        std::cout << "Testing loading compressed .npz file." << std::endl;
+    }
+    else
+    {
+        std::cout << "Testing loading uncompressed .npz file." << std::endl;
+    }
+
+    const std::string filepath = getTemporaryTestFile(".npz");
+
+    //
+    // Generate our test file in NumPy and save our expected values.
+    //
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = testFuncs.call(
+                               "generateNpzFile",
+                               filepath,
+                               compressed);
+    POTHOS_TEST_TRUE(
+        typeid(Pothos::ProxyMap) ==
+        expectedOutputs.toObject().type());
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    Npz1DContentsMap testValues1D;
+    Npz2DContentsMap testValues2D;
+    proxyMapToNpzTestInputs(
+        expectedOutputs,
+        &testValues1D,
+        &testValues2D);
+
+    // The keys come from the archive's directory, in any order.
+    auto allKeys = Pothos::BlockRegistry::make(
+                       "/numpy/npz_source",
+                       filepath,
+                       testValues1D.begin()->first,
+                       false /*repeat*/).call<std::vector<std::string>>("allKeys");
+    POTHOS_TEST_EQUAL(testValues1D.size() + testValues2D.size(), allKeys.size());
+    for(const auto& key: allKeys)
+    {
+        POTHOS_TEST_TRUE((testValues1D.count(key) > 0) || (testValues2D.count(key) > 0));
+    }
+
+    for(const auto& testValues: testValues1D)
+    {
+        const auto& key = testValues.first;
+        const auto& expectedOutputs = testValues.second;
+        testNpzSource1D(filepath, key, expectedOutputs);
+    }
+    for(const auto& testValues: testValues2D)
+    {
+        const auto& key = testValues.first;
+        const auto& expectedOutputs = testValues.second;
+        testNpzSource2D(filepath, key, expectedOutputs);
+    }
+}
+
+static void testNpzSink(
+    const std::string& filepath,
+    const std::string& key,
+    bool compressed,
+    bool append,
+    const Pothos::BufferChunk& values)
+{
+    const auto& dtype = values.dtype;
+
+    auto numpyNpzSink = Pothos::BlockRegistry::make(
+                            "/numpy/npz_sink",
+                            filepath,
+                            key,
+                            dtype,
+                            1 /*nchans*/,
+                            compressed,
+                            append);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        numpyNpzSink.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        key,
+        numpyNpzSink.call<std::string>("key"));
+    POTHOS_TEST_EQUAL(
+        compressed,
+        numpyNpzSink.call<bool>("compressed"));
+    POTHOS_TEST_EQUAL(
+        append,
+        numpyNpzSink.call<bool>("append"));
+
+    if(append)
+    {
+        const auto allKeys = numpyNpzSink.call<std::vector<std::string>>("allKeys");
+        POTHOS_TEST_TRUE(allKeys.end() != std::find(allKeys.begin(), allKeys.end(), key));
+    }
+
+    POTHOS_TEST_EQUAL(
+        dtype.name(),
+        getPortDType(numpyNpzSink, "inputPortInfo", 0).name());
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", values);
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+
+        topology.connect(
+            feederSource, 0,
+            numpyNpzSink, 0);
+
+        topology.commit();
+
+        // When this block exits, the flowgraph will stop.
+        Poco::Thread::sleep(10);
+    }
+}
+
+static void testNpzSink(bool compressed)
+{
+    static constexpr size_t numElements = 256;
+
+    static constexpr size_t minSize = (numElements * sizeof(std::int8_t))
+                                    + (numElements * sizeof(std::int16_t))
+                                    + (numElements * sizeof(std::int32_t))
+                                    + (numElements * sizeof(std::uint8_t))
+                                    + (numElements * sizeof(std::uint16_t))
+                                    + (numElements * sizeof(std::uint32_t))
+                                    + (numElements * sizeof(float))
+                                    + (numElements * sizeof(double))
+                                    + (numElements * sizeof(std::complex<float>))
+                                    + (numElements * sizeof(std::complex<double>));
 
     const std::string blockName = "/numpy/npz_sink";
     std::cout << "Testing " << blockName << " (" << (compressed ? "compressed" : "uncompressed") << ")" << std::endl;
@@ -554,56 +1176,466 @@ static void testNpzSink(bool compressed)
 
     Npz1DContentsMap testInputs;
 
-    //
-    // Generate our inputs.
-    //
-    const std::vector<std::string> typeNames =
+    //
+    // Generate our inputs.
+    //
+    const std::vector<std::string> typeNames =
+    {
+        "int8", "int16", "int32", "int64",
+        "uint8", "uint16", "uint32", "uint64",
+        "float32", "float64", "complex_float32", "complex_float64"
+    };
+    for(const std::string& type: typeNames)
+    {
+        testInputs.emplace(
+            type,
+            NPTests::getRandomInputs(type, numElements));
+    }
+
+    //
+    // Save generated files to the .NPZ file.
+    //
+    for(const auto& mapPair: testInputs)
+    {
+        const auto& typeName = mapPair.first;
+        const auto& inputs = mapPair.second;
+
+        testNpzSink(
+            filepath,
+            typeName,
+            compressed,
+            false /*append*/,
+            inputs);
+    }
+
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    // Since every channel should have written
+    if(!compressed)
+    {
+        POTHOS_TEST_GE(Poco::File(filepath).getSize(), minSize);
+    }
+
+    //
+    // Use NumPy directly to test our values.
+    //
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    testFuncs.call(
+        "checkNpzContents",
+        filepath,
+        npzTestInputsToProxyMap(testInputs));
+}
+
+// Appending to one key of an archive written by NumPy should leave the
+// other keys as they were. NumPy writes 2D arrays in C order, so this also
+// covers converting them to the sink's channel layout.
+static void testNpzSinkAppend(
+    const std::string& type,
+    const size_t nchans,
+    bool compressed)
+{
+    static constexpr size_t numElements = 256;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (append, " << nchans << " channels, "
+              << (compressed ? "compressed" : "uncompressed") << ")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npz");
+    const std::string key = type + ((1 == nchans) ? "_1D" : "_2D");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto originalValues = testFuncs.call(
+                              "generateNpzFile",
+                              filepath,
+                              compressed);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyNpzSink = Pothos::BlockRegistry::make(
+                            "/numpy/npz_sink",
+                            filepath,
+                            key,
+                            dtype,
+                            nchans,
+                            compressed,
+                            true /*append*/);
+
+    const auto allKeys = numpyNpzSink.call<std::vector<std::string>>("allKeys");
+    POTHOS_TEST_TRUE(allKeys.end() != std::find(allKeys.begin(), allKeys.end(), key));
+
+    std::vector<Pothos::BufferChunk> randomInputs;
+    std::vector<Pothos::Proxy> feederSources;
+    for(size_t chan = 0; chan < nchans; ++chan)
+    {
+        randomInputs.emplace_back(NPTests::getRandomInputs(type, numElements));
+
+        feederSources.emplace_back(Pothos::BlockRegistry::make(
+                                       "/blocks/feeder_source",
+                                       dtype));
+        feederSources.back().call("feedBuffer", randomInputs.back());
+    }
+
+    // Execute the topology.
     {
-        "int8", "int16", "int32", "int64",
-        "uint8", "uint16", "uint32", "uint64",
-        "float32", "float64", "complex_float32", "complex_float64"
-    };
-    for(const std::string& type: typeNames)
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            topology.connect(
+                feederSources[chan], 0,
+                numpyNpzSink, chan);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    testFuncs.call(
+        "checkAppendedNpzContents",
+        filepath,
+        originalValues,
+        key,
+        randomInputs);
+}
+
+// Every sync mode should write the same file, and the writer should be
+// drained once the topology stops.
+static void testFileSinkSyncMode(
+    const std::string& blockPath,
+    const std::string& syncMode)
+{
+    static constexpr size_t numElements = 1 << 16;
+    static const std::string type = "float64";
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << blockPath << " (sync mode: " << syncMode << ")" << std::endl;
+
+    const bool isNpz = ("/numpy/npz_sink" == blockPath);
+    const std::string filepath = getTemporaryTestFile(dtype, isNpz ? ".npz" : ".npy");
+    const std::string key = "synced";
+
+    auto sink = isNpz ? Pothos::BlockRegistry::make(
+                            blockPath,
+                            filepath,
+                            key,
+                            dtype,
+                            1 /*nchans*/,
+                            false /*compressed*/,
+                            false /*append*/)
+                      : Pothos::BlockRegistry::make(
+                            blockPath,
+                            filepath,
+                            dtype,
+                            1 /*nchans*/,
+                            false /*append*/);
+
+    sink.call("setSyncMode", syncMode);
+    sink.call("setSyncIntervalMB", 0.1);
+    POTHOS_TEST_EQUAL(syncMode, sink.call<std::string>("syncMode"));
+    POTHOS_TEST_EQUAL(0.1, sink.call<double>("syncIntervalMB"));
+    POTHOS_TEST_THROWS(sink.call("setSyncMode", "sometimes"), Pothos::Exception);
+    POTHOS_TEST_THROWS(sink.call("setSyncIntervalMB", 0.0), Pothos::Exception);
+
+    const auto randomInputs = NPTests::getRandomInputs(type, numElements);
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", randomInputs);
+
+    // Execute the topology.
     {
-        testInputs.emplace(
-            type,
-            NPTests::getRandomInputs(type, numElements));
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            sink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
     }
 
-    //
-    // Save generated files to the .NPZ file.
-    //
-    for(const auto& mapPair: testInputs)
+    POTHOS_TEST_EQUAL(size_t(0), sink.call<size_t>("writeQueueDepth"));
+    POTHOS_TEST_GE(sink.call<double>("writeBlockedSeconds"), 0.0);
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    if(isNpz)
     {
-        const auto& typeName = mapPair.first;
-        const auto& inputs = mapPair.second;
+        Npz1DContentsMap expectedContents;
+        expectedContents.emplace(key, randomInputs);
 
-        testNpzSink(
-            filepath,
-            typeName,
-            compressed,
-            false /*append*/,
-            inputs);
+        testFuncs.call("checkNpzContents", filepath, npzTestInputsToProxyMap(expectedContents));
     }
+    else testFuncs.call("checkNpyContents", filepath, randomInputs);
+}
+
+// Each column should be output on its own port, after the header.
+static void testTextSource(
+    const std::string& type,
+    const std::string& delimiter)
+{
+    const Pothos::DType dtype(type);
+    std::cout << "Testing /numpy/loadtxt with " << dtype.toString() << " (delimiter: \"" << delimiter << "\")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".txt");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
+    auto expectedOutputs = convert2DNumPyArrayToBufferChunks(testFuncs.call(
+                               "generate2DTextFile",
+                               filepath,
+                               dtype,
+                               delimiter));
     POTHOS_TEST_TRUE(Poco::File(filepath).exists());
 
-    // Since every channel should have written
-    if(!compressed)
+    auto textSource = Pothos::BlockRegistry::make(
+                          "/numpy/loadtxt",
+                          filepath,
+                          dtype,
+                          delimiter,
+                          1 /*skipRows*/,
+                          false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        textSource.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        delimiter,
+        textSource.call<std::string>("delimiter"));
+    POTHOS_TEST_EQUAL(
+        size_t(1),
+        textSource.call<size_t>("skipRows"));
+    POTHOS_TEST_FALSE(textSource.call<bool>("repeat"));
+
+    for(size_t chan = 0; chan < kNumChannels; ++chan)
     {
-        POTHOS_TEST_GE(Poco::File(filepath).getSize(), minSize);
+        POTHOS_TEST_EQUAL(
+            dtype.name(),
+            getPortDType(textSource, "outputPortInfo", chan).name());
     }
 
-    //
-    // Use NumPy directly to test our values.
-    //
+    test2DSource(
+        textSource,
+        expectedOutputs);
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/loadtxt", filepath, dtype, ";;", 1, false),
+        Pothos::Exception);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/loadtxt", filepath, "complex_float64", delimiter, 1, false),
+        Pothos::Exception);
+}
+
+// Write each input to its own column, then check the columns with NumPy
+// and by reading the file back in.
+static void testTextSink(
+    const std::string& type,
+    const std::string& delimiter)
+{
+    static constexpr size_t numElements = 256;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing /numpy/savetxt with " << dtype.toString() << " (delimiter: \"" << delimiter << "\")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".txt");
+
+    auto textSink = Pothos::BlockRegistry::make(
+                        "/numpy/savetxt",
+                        filepath,
+                        dtype,
+                        kNumChannels,
+                        delimiter,
+                        false /*append*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        textSink.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        delimiter,
+        textSink.call<std::string>("delimiter"));
+    POTHOS_TEST_FALSE(textSink.call<bool>("append"));
+
+    std::vector<Pothos::BufferChunk> randomInputs;
+    std::vector<Pothos::Proxy> feederSources;
+    for(size_t chan = 0; chan < kNumChannels; ++chan)
+    {
+        randomInputs.emplace_back(NPTests::getRandomInputs(type, numElements));
+
+        feederSources.emplace_back(Pothos::BlockRegistry::make(
+                                       "/blocks/feeder_source",
+                                       dtype));
+        feederSources.back().call("feedBuffer", randomInputs.back());
+    }
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < kNumChannels; ++chan)
+        {
+            topology.connect(
+                feederSources[chan], 0,
+                textSink, chan);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    for(size_t chan = 0; chan < kNumChannels; ++chan)
+    {
+        testFuncs.call("checkTextChannelContents", filepath, delimiter, chan, randomInputs[chan]);
+    }
+
+    auto textSource = Pothos::BlockRegistry::make(
+                          "/numpy/loadtxt",
+                          filepath,
+                          dtype,
+                          delimiter,
+                          0 /*skipRows*/,
+                          false /*repeat*/);
+    test2DSource(textSource, randomInputs);
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/savetxt", filepath, dtype, kNumChannels, "", false),
+        Pothos::Exception);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/savetxt", filepath, "complex_float64", kNumChannels, delimiter, false),
+        Pothos::Exception);
+}
+
+// An unaligned offset or a non-native byte order means the samples have to
+// be copied instead of output in place.
+static void testRawFileSource(
+    const std::string& type,
+    const std::string& byteOrder,
+    const size_t offset)
+{
+    const Pothos::DType dtype(type);
+    std::cout << "Testing /numpy/fromfile with " << dtype.toString() << " (" << byteOrder << ", offset " << offset << ")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".bin");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = testFuncs.call<Pothos::BufferChunk>(
+                               "generate1DRawFile",
+                               filepath,
+                               dtype,
+                               byteOrder,
+                               offset);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto rawSource = Pothos::BlockRegistry::make(
+                         "/numpy/fromfile",
+                         filepath,
+                         dtype,
+                         offset,
+                         byteOrder,
+                         false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        rawSource.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        offset,
+        rawSource.call<size_t>("offset"));
+    POTHOS_TEST_EQUAL(
+        byteOrder,
+        rawSource.call<std::string>("byteOrder"));
+    POTHOS_TEST_EQUAL(
+        expectedOutputs.elements(),
+        rawSource.call<size_t>("numElements"));
+    POTHOS_TEST_EQUAL(
+        dtype.name(),
+        getPortDType(rawSource, "outputPortInfo", 0).name());
+
+    test1DSource(
+        rawSource,
+        expectedOutputs);
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/fromfile", filepath, dtype, offset, "middle", false),
+        Pothos::Exception);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/fromfile", filepath, dtype, size_t(Poco::File(filepath).getSize())+1, byteOrder, false),
+        Pothos::Exception);
+}
+
+// Append to a file written by NumPy, then read back what was appended.
+static void testRawFileSink(
+    const std::string& type,
+    const std::string& byteOrder)
+{
+    static constexpr size_t numElements = 256;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing /numpy/tofile with " << dtype.toString() << " (" << byteOrder << ")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".bin");
+    const auto randomInputs = NPTests::getRandomInputs(type, numElements);
+
     auto env = Pothos::ProxyEnvironment::make("python");
     auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
 
+    auto originalValues = testFuncs.call(
+                              "generate1DRawFile",
+                              filepath,
+                              dtype,
+                              byteOrder,
+                              0 /*offset*/);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", randomInputs);
+
+    auto rawSink = Pothos::BlockRegistry::make(
+                       "/numpy/tofile",
+                       filepath,
+                       dtype,
+                       byteOrder,
+                       true /*append*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        rawSink.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        byteOrder,
+        rawSink.call<std::string>("byteOrder"));
+    POTHOS_TEST_TRUE(rawSink.call<bool>("append"));
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            rawSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
     testFuncs.call(
-        "checkNpzContents",
+        "checkAppendedRawContents",
         filepath,
-        npzTestInputsToProxyMap(testInputs));
+        byteOrder,
+        originalValues,
+        randomInputs);
+
+    auto rawSource = Pothos::BlockRegistry::make(
+                         "/numpy/fromfile",
+                         filepath,
+                         dtype,
+                         0 /*offset*/,
+                         byteOrder,
+                         false /*repeat*/);
+    rawSource.call("setStartIndex", numElements);
+    test1DSource(rawSource, randomInputs);
 }
 
 //
@@ -626,6 +1658,32 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npy_source)
     testNpySource("complex_float64");
 }
 
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_playlist_source)
+{
+    testNpyPlaylistSource("int16");
+    testNpyPlaylistSource("uint32");
+    testNpyPlaylistSource("float64");
+    testNpyPlaylistSource("complex_float32");
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_source_read_ahead)
+{
+    for(bool dropReadPages: {false, true})
+    {
+        testNpySourceReadAhead(dropReadPages, false /*prefetchThread*/);
+        testNpySourceReadAhead(dropReadPages, true /*prefetchThread*/);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_file_source_windows)
+{
+    for(const auto& blockPath: {"/numpy/npy_source", "/numpy/npz_source"})
+    {
+        testFileSourceWindow(blockPath, 0);
+        testFileSourceWindow(blockPath, 50);
+    }
+}
+
 POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink)
 {
     testNpySink("int8");
@@ -642,6 +1700,55 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink)
     testNpySink("complex_float64");
 }
 
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink_append)
+{
+    for(const auto& generatorName: {"generate1DNpyFile", "generateInterrupted1DNpyFile"})
+    {
+        testNpySinkAppend("int8", generatorName);
+        testNpySinkAppend("int16", generatorName);
+        testNpySinkAppend("int32", generatorName);
+        testNpySinkAppend("int64", generatorName);
+        testNpySinkAppend("uint8", generatorName);
+        testNpySinkAppend("uint16", generatorName);
+        testNpySinkAppend("uint32", generatorName);
+        testNpySinkAppend("uint64", generatorName);
+        testNpySinkAppend("float32", generatorName);
+        testNpySinkAppend("float64", generatorName);
+        testNpySinkAppend("complex_float32", generatorName);
+        testNpySinkAppend("complex_float64", generatorName);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink_no_samples)
+{
+    testNpySinkNoSamples();
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink_segments)
+{
+    testNpySinkSegments("samples");
+    testNpySinkSegments("label");
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_trigger_sink)
+{
+    testNpyTriggerSink("label");
+    testNpyTriggerSink("level");
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_multichannel_file_sinks)
+{
+    for(const auto& blockPath: {"/numpy/npy_sink", "/numpy/npz_sink"})
+    {
+        testMultichannelFileSink(blockPath, "int8");
+        testMultichannelFileSink(blockPath, "uint16");
+        testMultichannelFileSink(blockPath, "int32");
+        testMultichannelFileSink(blockPath, "uint64");
+        testMultichannelFileSink(blockPath, "float32");
+        testMultichannelFileSink(blockPath, "complex_float64");
+    }
+}
+
 POTHOS_TEST_BLOCK("/numpy/tests", test_npz_source)
 {
     testNpzSource(false /*compressed*/);
@@ -653,3 +1760,104 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npz_sink)
     testNpzSink(false /*compressed*/);
     testNpzSink(true /*compressed*/);
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_npz_sink_append)
+{
+    for(bool compressed: {false, true})
+    {
+        for(size_t nchans: {size_t(1), kNumChannels})
+        {
+            testNpzSinkAppend("int8", nchans, compressed);
+            testNpzSinkAppend("uint16", nchans, compressed);
+            testNpzSinkAppend("int32", nchans, compressed);
+            testNpzSinkAppend("uint64", nchans, compressed);
+            testNpzSinkAppend("float32", nchans, compressed);
+            testNpzSinkAppend("float64", nchans, compressed);
+        }
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_file_sink_sync_modes)
+{
+    for(const auto& blockPath: {"/numpy/npy_sink", "/numpy/npz_sink"})
+    {
+        testFileSinkSyncMode(blockPath, "never");
+        testFileSinkSyncMode(blockPath, "close");
+        testFileSinkSyncMode(blockPath, "interval");
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_loadtxt)
+{
+    for(const auto& delimiter: {",", "\t", ""})
+    {
+        testTextSource("int8", delimiter);
+        testTextSource("int16", delimiter);
+        testTextSource("int32", delimiter);
+        testTextSource("int64", delimiter);
+        testTextSource("uint8", delimiter);
+        testTextSource("uint16", delimiter);
+        testTextSource("uint32", delimiter);
+        testTextSource("uint64", delimiter);
+        testTextSource("float32", delimiter);
+        testTextSource("float64", delimiter);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_savetxt)
+{
+    for(const auto& delimiter: {",", "\t"})
+    {
+        testTextSink("int8", delimiter);
+        testTextSink("int16", delimiter);
+        testTextSink("int32", delimiter);
+        testTextSink("int64", delimiter);
+        testTextSink("uint8", delimiter);
+        testTextSink("uint16", delimiter);
+        testTextSink("uint32", delimiter);
+        testTextSink("uint64", delimiter);
+        testTextSink("float32", delimiter);
+        testTextSink("float64", delimiter);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_fromfile)
+{
+    for(const auto& byteOrder: {"native", "little", "big"})
+    {
+        for(size_t offset: {size_t(0), size_t(3)})
+        {
+            testRawFileSource("int8", byteOrder, offset);
+            testRawFileSource("int16", byteOrder, offset);
+            testRawFileSource("int32", byteOrder, offset);
+            testRawFileSource("int64", byteOrder, offset);
+            testRawFileSource("uint8", byteOrder, offset);
+            testRawFileSource("uint16", byteOrder, offset);
+            testRawFileSource("uint32", byteOrder, offset);
+            testRawFileSource("uint64", byteOrder, offset);
+            testRawFileSource("float32", byteOrder, offset);
+            testRawFileSource("float64", byteOrder, offset);
+            testRawFileSource("complex_float32", byteOrder, offset);
+            testRawFileSource("complex_float64", byteOrder, offset);
+        }
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_tofile)
+{
+    for(const auto& byteOrder: {"native", "little", "big"})
+    {
+        testRawFileSink("int8", byteOrder);
+        testRawFileSink("int16", byteOrder);
+        testRawFileSink("int32", byteOrder);
+        testRawFileSink("int64", byteOrder);
+        testRawFileSink("uint8", byteOrder);
+        testRawFileSink("uint16", byteOrder);
+        testRawFileSink("uint32", byteOrder);
+        testRawFileSink("uint64", byteOrder);
+        testRawFileSink("float32", byteOrder);
+        testRawFileSink("float64", byteOrder);
+        testRawFileSink("complex_float32", byteOrder);
+        testRawFileSink("complex_float64", byteOrder);
+    }
+}
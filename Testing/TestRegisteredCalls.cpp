@@ -147,3 +147,42 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_registered_string_calls)
 
     std::cout << json.dump() << std::endl;
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_benchmark)
+{
+    // Keep this short, since this only checks that results are reported.
+    const std::string blockPath = "/numpy/sin";
+    constexpr size_t numElements = 1 << 14;
+    constexpr size_t numChains = 2;
+
+    const auto output = nlohmann::json::parse(
+                            NPTests::getAndCallPlugin<std::string>(
+                                "/numpy/benchmark/run",
+                                blockPath,
+                                numElements,
+                                numChains));
+    std::cout << output.dump() << std::endl;
+
+    const auto& results = output["results"];
+    POTHOS_TEST_FALSE(results.empty());
+
+    for(const auto& result: results)
+    {
+        POTHOS_TEST_EQUAL(blockPath, result["path"].get<std::string>());
+        POTHOS_TEST_FALSE(result.contains("error"));
+        POTHOS_TEST_EQUAL(
+            result["elementsIn"].get<size_t>(),
+            result["elementsOut"].get<size_t>());
+        POTHOS_TEST_GT(result["msps"].get<double>(), 0.0);
+
+        const auto& parallel = result["parallel"];
+        POTHOS_TEST_EQUAL(numChains, parallel["chains"].get<size_t>());
+        POTHOS_TEST_EQUAL(
+            numChains * result["elementsIn"].get<size_t>(),
+            parallel["elementsIn"].get<size_t>());
+        POTHOS_TEST_EQUAL(
+            parallel["elementsIn"].get<size_t>(),
+            parallel["elementsOut"].get<size_t>());
+        POTHOS_TEST_GT(parallel["msps"].get<double>(), 0.0);
+    }
+}
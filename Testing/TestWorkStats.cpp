@@ -0,0 +1,70 @@
+// Copyright (c) 2023 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include <Pothos/Testing.hpp>
+
+#include <iostream>
+#include <string>
+
+static void testWorkStats(
+    const std::string& blockPath,
+    const std::string& expectedEnvironment)
+{
+    constexpr size_t numBuffers = 4;
+    constexpr size_t bufferLen = 1024;
+
+    std::cout << "Testing " << blockPath << " (" << expectedEnvironment << ")..." << std::endl;
+
+    const Pothos::DType dtype("float64");
+
+    auto feeder = Pothos::BlockRegistry::make("/blocks/feeder_source", dtype);
+    auto block = Pothos::BlockRegistry::make(blockPath, dtype);
+    auto sink = Pothos::BlockRegistry::make("/blocks/collector_sink", dtype);
+    POTHOS_TEST_EQUAL(expectedEnvironment, block.getEnvironment()->getName());
+
+    for(size_t buff = 0; buff < numBuffers; ++buff)
+    {
+        feeder.call("feedBuffer", NPTests::getRandomInputs(dtype.name(), bufferLen));
+    }
+
+    {
+        Pothos::Topology topology;
+        topology.connect(feeder, 0, block, 0);
+        topology.connect(block, 0, sink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    const auto stats = nlohmann::json::parse(block.call<std::string>("workStats"));
+
+    const size_t numElements = numBuffers * bufferLen;
+    POTHOS_TEST_EQUAL(numElements, sink.call<Pothos::BufferChunk>("getBuffer").elements());
+    POTHOS_TEST_EQUAL(numElements, stats["elementsConsumed"].get<size_t>());
+    POTHOS_TEST_EQUAL(numElements, stats["elementsProduced"].get<size_t>());
+    POTHOS_TEST_TRUE(stats["workCalls"].get<size_t>() >= 1);
+    POTHOS_TEST_TRUE(stats["workCalls"].get<size_t>() >= stats["zeroElementReturns"].get<size_t>());
+    POTHOS_TEST_TRUE(stats["funcSeconds"].get<double>() > 0.0);
+    POTHOS_TEST_TRUE(stats["copySeconds"].get<double>() >= 0.0);
+
+    // The individual probes should match the JSON dump.
+    POTHOS_TEST_EQUAL(stats["workCalls"].get<size_t>(), block.call<size_t>("workCalls"));
+    POTHOS_TEST_EQUAL(numElements, block.call<size_t>("elementsConsumed"));
+    POTHOS_TEST_EQUAL(numElements, block.call<size_t>("elementsProduced"));
+
+    block.call("resetWorkStats");
+    POTHOS_TEST_EQUAL(size_t(0), block.call<size_t>("workCalls"));
+    POTHOS_TEST_EQUAL(size_t(0), block.call<size_t>("elementsProduced"));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_work_stats)
+{
+    testWorkStats("/numpy/sin", "managed");
+    testWorkStats("/numpy/i0", "python");
+}